@@ -15,6 +15,30 @@
 
 using namespace tennis;
 
+// MARK: - Conversion Scratch
+
+// NSArray contents are converted into per-thread vectors that keep their
+// capacity, so repeated calls stop allocating once the largest session
+// has been seen. Each accessor returns its vector emptied.
+
+static std::vector<double>& scratchDurations() {
+    thread_local std::vector<double> values;
+    values.clear();
+    return values;
+}
+
+static std::vector<uint8_t>& scratchIntensities() {
+    thread_local std::vector<uint8_t> values;
+    values.clear();
+    return values;
+}
+
+static std::vector<double>& scratchRestDurations() {
+    thread_local std::vector<double> values;
+    values.clear();
+    return values;
+}
+
 // MARK: - TennisAnalysisResult Implementation
 
 @implementation TennisAnalysisResult
@@ -48,7 +72,7 @@ using namespace tennis;
     }
     
     // Convert NSArray to std::vector
-    std::vector<double> durationsVec;
+    std::vector<double>& durationsVec = scratchDurations();
     durationsVec.reserve(durations.count);
     for (NSNumber *duration in durations) {
         double value = [duration doubleValue];
@@ -58,7 +82,7 @@ using namespace tennis;
         durationsVec.push_back(value);
     }
     
-    std::vector<uint8_t> intensitiesVec;
+    std::vector<uint8_t>& intensitiesVec = scratchIntensities();
     intensitiesVec.reserve(intensities.count);
     for (NSNumber *intensity in intensities) {
         uint8_t value = [intensity unsignedCharValue];
@@ -69,7 +93,7 @@ using namespace tennis;
     }
     
     // Convert rest durations if provided
-    std::vector<double> restDurationsVec;
+    std::vector<double>& restDurationsVec = scratchRestDurations();
     if (restDurations) {
         restDurationsVec.reserve(restDurations.count);
         for (NSNumber *restDuration in restDurations) {
@@ -99,7 +123,7 @@ using namespace tennis;
         return 0.0;
     }
     
-    std::vector<double> durationsVec;
+    std::vector<double>& durationsVec = scratchDurations();
     durationsVec.reserve(durations.count);
     for (NSNumber *duration in durations) {
         durationsVec.push_back([duration doubleValue]);
@@ -114,13 +138,13 @@ using namespace tennis;
         return 0.0;
     }
     
-    std::vector<double> durationsVec;
+    std::vector<double>& durationsVec = scratchDurations();
     durationsVec.reserve(durations.count);
     for (NSNumber *duration in durations) {
         durationsVec.push_back([duration doubleValue]);
     }
     
-    std::vector<double> restDurationsVec;
+    std::vector<double>& restDurationsVec = scratchRestDurations();
     if (restDurations) {
         restDurationsVec.reserve(restDurations.count);
         for (NSNumber *restDuration in restDurations) {
@@ -141,13 +165,13 @@ using namespace tennis;
         return 0.0;
     }
     
-    std::vector<double> durationsVec;
+    std::vector<double>& durationsVec = scratchDurations();
     durationsVec.reserve(durations.count);
     for (NSNumber *duration in durations) {
         durationsVec.push_back([duration doubleValue]);
     }
     
-    std::vector<uint8_t> intensitiesVec;
+    std::vector<uint8_t>& intensitiesVec = scratchIntensities();
     intensitiesVec.reserve(intensities.count);
     for (NSNumber *intensity in intensities) {
         intensitiesVec.push_back([intensity unsignedCharValue]);
@@ -162,13 +186,13 @@ using namespace tennis;
         return 0.0;
     }
     
-    std::vector<double> durationsVec;
+    std::vector<double>& durationsVec = scratchDurations();
     durationsVec.reserve(durations.count);
     for (NSNumber *duration in durations) {
         durationsVec.push_back([duration doubleValue]);
     }
     
-    std::vector<uint8_t> intensitiesVec;
+    std::vector<uint8_t>& intensitiesVec = scratchIntensities();
     intensitiesVec.reserve(intensities.count);
     for (NSNumber *intensity in intensities) {
         intensitiesVec.push_back([intensity unsignedCharValue]);
@@ -112,8 +112,7 @@ double TennisAnalyzer::calculateConsistencyScore(
     double durationConsistency = 1.0 / (1.0 + durationCV);
     
     // Calculate intensity consistency
-    std::vector<double> intensityDoubles(intensities.begin(), intensities.end());
-    double intensityCV = coefficientOfVariation(intensityDoubles);
+    double intensityCV = coefficientOfVariation(intensities);
     double intensityConsistency = 1.0 / (1.0 + intensityCV);
     
     // Combined consistency score (weighted average)
@@ -244,6 +243,31 @@ double TennisAnalyzer::coefficientOfVariation(const std::vector<double>& values)
     return stdDev / meanValue;
 }
 
+double TennisAnalyzer::coefficientOfVariation(const std::vector<uint8_t>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    
+    // Same arithmetic, in the same order, as widening to doubles first
+    double meanValue = std::accumulate(values.begin(), values.end(), 0.0) /
+                       static_cast<double>(values.size());
+    if (std::abs(meanValue) < EPSILON) {
+        return 0.0;
+    }
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    
+    double sumSquaredDiff = 0.0;
+    for (uint8_t value : values) {
+        double diff = static_cast<double>(value) - meanValue;
+        sumSquaredDiff += diff * diff;
+    }
+    
+    double variance = sumSquaredDiff / static_cast<double>(values.size() - 1);
+    return std::sqrt(variance) / meanValue;
+}
+
 double TennisAnalyzer::normalizeIntensity(uint8_t intensity) {
     // Normalize from [1, 5] to [0.0, 1.0]
     return static_cast<double>(intensity - MIN_INTENSITY) / 
@@ -163,6 +163,11 @@ private:
      */
     static double coefficientOfVariation(const std::vector<double>& values);
     
+    /**
+     * @brief Coefficient of variation of intensity levels, without a widened copy
+     */
+    static double coefficientOfVariation(const std::vector<uint8_t>& values);
+    
     /**
      * @brief Normalize intensity to 0.0-1.0 range
      */
@@ -0,0 +1,287 @@
+//
+//  bench_harness.hpp
+//  Tennis Analyzer Benchmarks
+//
+//  Small self-contained microbenchmark harness in the spirit of Google
+//  Benchmark (no external dependencies, no network access needed)
+//
+
+#ifndef TENNIS_BENCH_HARNESS_HPP
+#define TENNIS_BENCH_HARNESS_HPP
+
+#include "perf_counters.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace tennis {
+namespace bench {
+
+/**
+ * @brief Heap allocations performed by the process so far
+ *
+ * Defined by the benchmark binary: from its own replacement operator new,
+ * or from the library's allocation tracker in instrumentation builds.
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Keep `value` alive so the optimizer cannot drop the computation
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Timestamp counter used for the bytes/cycle column
+ *
+ * x86 reads the TSC, AArch64 the virtual counter; both tick at a fixed
+ * rate, so the figure is per reference cycle rather than per core cycle.
+ */
+inline bool cycleCounterAvailable() {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief One benchmark: a kernel applied to a fixed input
+ */
+struct Case {
+    std::string kernel;        // e.g. "analyze"
+    std::string distribution;  // Input distribution name
+    size_t sets;               // Sets processed per call
+    size_t bytesPerCall;       // Input bytes touched per call
+    std::function<void()> body;
+    bool expectZeroAllocations = true; // Steady-state calls must not touch the heap
+
+    std::string name() const {
+        return kernel + "/" + distribution + "/" + std::to_string(sets);
+    }
+};
+
+struct Measurement {
+    std::string name;
+    std::string kernel;
+    size_t sets = 0;
+    uint64_t iterations = 0;     // Per repetition
+    size_t repetitions = 0;
+    double nsPerCall = 0.0;      // Median over repetitions
+    double nsPerCallMad = 0.0;   // Median absolute deviation of ns/call
+    double nsPerSet = 0.0;
+    double bytesPerCycle = 0.0;  // 0 when no cycle counter is available
+    double allocsPerCall = 0.0;
+
+    // Hardware counters per set, from PerfCounters (see hasCounter)
+    double countersPerSet[PerfCounters::EVENT_COUNT] = {0.0, 0.0, 0.0, 0.0};
+    bool hasCounter[PerfCounters::EVENT_COUNT] = {false, false, false, false};
+};
+
+struct Options {
+    double minTimeSeconds = 0.1;  // Minimum measured time per case
+    size_t maxSets = 10000000;    // Largest session size to run
+    std::string filter;           // Substring a case name must contain
+    size_t repetitions = 1;       // Timed runs per case, each of minTimeSeconds
+    size_t rounds = 1;            // Passes over the whole suite, each with freshly built inputs
+};
+
+/**
+ * @brief Median of `values` (reorders them)
+ */
+inline double median(std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double result = values[middle];
+    if (values.size() % 2 == 0) {
+        result = (result + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+    }
+    return result;
+}
+
+/**
+ * @brief Median absolute deviation from `center`
+ */
+inline double medianAbsoluteDeviation(const std::vector<double>& values, double center) {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) {
+        deviations.push_back(std::fabs(v - center));
+    }
+    return median(deviations);
+}
+
+/**
+ * @brief Run a case: calibrate the iteration count, then measure it
+ * `options.repetitions` times and report the median
+ *
+ * Allocations and hardware counters are totalled over all repetitions.
+ *
+ * @param counters Hardware counters read around the measured loop (optional)
+ */
+inline Measurement run(const Case& benchmarkCase, const Options& options, PerfCounters* counters = nullptr) {
+    using Clock = std::chrono::steady_clock;
+
+    // Warm caches and any lazily initialized state
+    benchmarkCase.body();
+
+    // Grow the iteration count until a run takes a tenth of the budget
+    uint64_t iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            benchmarkCase.body();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= options.minTimeSeconds / 10.0 || iterations >= (1ULL << 30)) {
+            double scale = seconds > 0.0 ? options.minTimeSeconds / seconds : 10.0;
+            iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1;
+            break;
+        }
+        iterations *= 10;
+    }
+
+    const size_t repetitions = std::max<size_t>(options.repetitions, 1);
+    std::vector<double> samples; // ns/call of each repetition
+    samples.reserve(repetitions);
+
+    const uint64_t allocationsBefore = allocationCount();
+    if (counters) {
+        counters->start();
+    }
+    const uint64_t cyclesBefore = readCycleCounter();
+    for (size_t r = 0; r < repetitions; ++r) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            benchmarkCase.body();
+        }
+        const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        samples.push_back(elapsedNs / static_cast<double>(iterations));
+    }
+    const uint64_t cycles = readCycleCounter() - cyclesBefore;
+    if (counters) {
+        counters->stop();
+    }
+    const uint64_t allocations = allocationCount() - allocationsBefore;
+    const double calls = static_cast<double>(iterations) * static_cast<double>(repetitions);
+
+    Measurement m;
+    m.name = benchmarkCase.name();
+    m.kernel = benchmarkCase.kernel;
+    m.sets = benchmarkCase.sets;
+    m.iterations = iterations;
+    m.repetitions = repetitions;
+    m.nsPerCall = median(samples);
+    m.nsPerCallMad = medianAbsoluteDeviation(samples, m.nsPerCall);
+    m.nsPerSet = benchmarkCase.sets > 0 ? m.nsPerCall / static_cast<double>(benchmarkCase.sets) : 0.0;
+    if (cycleCounterAvailable() && cycles > 0) {
+        m.bytesPerCycle = static_cast<double>(benchmarkCase.bytesPerCall) * calls / static_cast<double>(cycles);
+    }
+    m.allocsPerCall = static_cast<double>(allocations) / calls;
+
+    if (counters && benchmarkCase.sets > 0) {
+        const PerfCounters::Reading reading = counters->read();
+        const double setsMeasured = static_cast<double>(benchmarkCase.sets) * calls;
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            m.hasCounter[e] = reading.valid[e];
+            m.countersPerSet[e] = reading.values[e] / setsMeasured;
+        }
+    }
+    return m;
+}
+
+/**
+ * @brief Combine one case's measurements from several rounds into one
+ *
+ * The time is the median of the round medians. The deviation is the larger
+ * of the spread between rounds and the typical spread within one, so drift
+ * over a run counts as noise rather than hiding behind a tight repetition MAD.
+ */
+inline Measurement combineRounds(const std::vector<Measurement>& rounds) {
+    Measurement m = rounds.front();
+    if (rounds.size() == 1) {
+        return m;
+    }
+    std::vector<double> times;
+    std::vector<double> deviations;
+    m.repetitions = 0;
+    for (const Measurement& round : rounds) {
+        times.push_back(round.nsPerCall);
+        deviations.push_back(round.nsPerCallMad);
+        m.repetitions += round.repetitions;
+        m.allocsPerCall = std::max(m.allocsPerCall, round.allocsPerCall);
+    }
+    std::vector<double> ordered = times;
+    m.nsPerCall = median(ordered);
+    m.nsPerCallMad = std::max(medianAbsoluteDeviation(times, m.nsPerCall), median(deviations));
+    m.nsPerSet = m.sets > 0 ? m.nsPerCall / static_cast<double>(m.sets) : 0.0;
+    return m;
+}
+
+inline void printHeader() {
+    std::printf("%-48s %12s %14s %10s %12s %12s %10s %10s %12s %12s\n",
+                "Benchmark", "Iterations", "ns/call", "ns/set", "bytes/cycle", "allocs/call",
+                "cyc/set", "ins/set", "cmiss/set", "bmiss/set");
+    std::printf("%s\n", std::string(161, '-').c_str());
+}
+
+inline void printMeasurement(const Measurement& m) {
+    char bytesPerCycle[32];
+    if (cycleCounterAvailable()) {
+        std::snprintf(bytesPerCycle, sizeof(bytesPerCycle), "%.3f", m.bytesPerCycle);
+    } else {
+        std::snprintf(bytesPerCycle, sizeof(bytesPerCycle), "n/a");
+    }
+    char counters[PerfCounters::EVENT_COUNT][32];
+    for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+        if (m.hasCounter[e]) {
+            std::snprintf(counters[e], sizeof(counters[e]), "%.3f", m.countersPerSet[e]);
+        } else {
+            std::snprintf(counters[e], sizeof(counters[e]), "n/a");
+        }
+    }
+    std::printf("%-48s %12llu %14.1f %10.3f %12s %12.2f %10s %10s %12s %12s\n",
+                m.name.c_str(), static_cast<unsigned long long>(m.iterations),
+                m.nsPerCall, m.nsPerSet, bytesPerCycle, m.allocsPerCall,
+                counters[PerfCounters::Cycles], counters[PerfCounters::Instructions],
+                counters[PerfCounters::CacheMisses], counters[PerfCounters::BranchMisses]);
+    std::fflush(stdout);
+}
+
+} // namespace bench
+} // namespace tennis
+
+#endif // TENNIS_BENCH_HARNESS_HPP
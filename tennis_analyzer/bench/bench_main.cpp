@@ -0,0 +1,647 @@
+//
+//  bench_main.cpp
+//  Tennis Analyzer Benchmarks
+//
+//  Microbenchmarks for the analysis kernels across session sizes and
+//  intensity distributions
+//
+
+#include "allocation_tracker.hpp"
+#include "analysis_kernels.hpp"
+#include "bench_harness.hpp"
+#include "bench_report.hpp"
+#include "latency_histogram.hpp"
+#include "packed_result.hpp"
+#include "scalability.hpp"
+#include "session_batch.hpp"
+#include "tennis_analyzer.hpp"
+#include "trace.hpp"
+#include "workload_generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// MARK: - Allocation counting
+
+#if TENNIS_ANALYZER_TRACK_ALLOCATIONS
+
+// The library replaces operator new itself in instrumentation builds
+uint64_t tennis::bench::allocationCount() {
+    return tennis::processAllocationCounts().allocations;
+}
+
+#else
+
+static std::atomic<uint64_t> allocations{0};
+
+uint64_t tennis::bench::allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// The replacements are kept out of line: once inlined into a caller, GCC
+// pairs malloc/free with new/delete and reports mismatches that are not there
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif // TENNIS_ANALYZER_TRACK_ALLOCATIONS
+
+namespace {
+
+using namespace tennis;
+using namespace tennis::bench;
+
+// MARK: - Input generation
+
+/**
+ * @brief SplitMix64; fixed seed so every run sees the same inputs
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    uint64_t state_;
+};
+
+struct Session {
+    std::vector<double> durations;
+    std::vector<uint8_t> intensities;
+};
+
+/**
+ * @brief Intensity (and duration) distributions the kernels are measured on
+ *
+ * - constant: every set identical (zero variance paths)
+ * - uniform: intensity uniform over 1-5, durations uniform over 30-600 s
+ * - skewed: mostly intensity 5 with short rallies and occasional long drills
+ * - generated: rally/serve/drill mix from the default WorkloadGenerator
+ */
+const char* const DISTRIBUTIONS[] = {"constant", "uniform", "skewed", "generated"};
+
+Session makeSession(const std::string& distribution, size_t sets) {
+    Session session;
+    if (distribution == "generated") {
+        WorkloadConfig config;
+        config.minSets = sets;
+        config.maxSets = sets;
+        GeneratedSession generated;
+        WorkloadGenerator(config).generate(0, generated);
+        session.durations = std::move(generated.durations);
+        session.intensities = std::move(generated.intensities);
+        return session;
+    }
+
+    session.durations.resize(sets);
+    session.intensities.resize(sets);
+    Random random(0x7E4415ULL ^ sets);
+
+    for (size_t i = 0; i < sets; ++i) {
+        if (distribution == "constant") {
+            session.durations[i] = 300.0;
+            session.intensities[i] = 3;
+        } else if (distribution == "uniform") {
+            session.durations[i] = 30.0 + random.uniform() * 570.0;
+            session.intensities[i] = static_cast<uint8_t>(1 + random.next() % 5);
+        } else {
+            const double u = random.uniform();
+            session.durations[i] = u < 0.9 ? 10.0 + random.uniform() * 50.0 : 600.0 + random.uniform() * 1200.0;
+            session.intensities[i] = random.uniform() < 0.8 ? 5 : static_cast<uint8_t>(1 + random.next() % 4);
+        }
+    }
+    return session;
+}
+
+// MARK: - Cases
+
+constexpr size_t SET_BYTES = sizeof(double) + sizeof(uint8_t);
+constexpr size_t BATCH_SESSION_SETS = 32;
+constexpr size_t MAX_INVALID_SETS = 1000000;
+
+/**
+ * @brief Header-only analysis of a session whose size is a compile-time
+ * constant, for comparison with the library's analyze
+ */
+template <size_t N>
+Case inlineCase(const std::string& distribution, const Session& session) {
+    std::array<double, N> durations;
+    std::array<uint8_t, N> intensities;
+    std::copy_n(session.durations.begin(), N, durations.begin());
+    std::copy_n(session.intensities.begin(), N, intensities.begin());
+    return {"analyzeInline", distribution, N, N * SET_BYTES, [durations, intensities] {
+        AnalysisResult result;
+        doNotOptimize(analysis::tryAnalyze(durations, intensities, result));
+        doNotOptimize(result);
+    }};
+}
+
+std::vector<Case> makeCases(const std::string& distribution, const Session& session,
+                            const std::vector<uint8_t>* invalid, const SessionBatch& batch,
+                            BatchResult& batchResult, TennisAnalyzer& analyzer) {
+    const size_t sets = session.durations.size();
+    const size_t durationBytes = sets * sizeof(double);
+    const size_t allBytes = sets * SET_BYTES;
+    const Session* s = &session;
+
+    std::vector<Case> cases;
+    cases.push_back({"analyze", distribution, sets, allBytes, [s, &analyzer] {
+        doNotOptimize(analyzer.analyze(s->durations, s->intensities));
+    }});
+    cases.push_back({"tryAnalyze", distribution, sets, allBytes, [s, &analyzer] {
+        AnalysisResult result;
+        doNotOptimize(analyzer.tryAnalyze(s->durations, s->intensities, result));
+        doNotOptimize(result);
+    }});
+    if (sets == 5) {
+        cases.push_back(inlineCase<5>(distribution, session));
+    } else if (sets == 50) {
+        cases.push_back(inlineCase<50>(distribution, session));
+    } else {
+        cases.push_back({"analyzeInline", distribution, sets, allBytes, [s] {
+            AnalysisResult result;
+            doNotOptimize(analysis::tryAnalyze(s->durations.data(), s->intensities.data(), s->durations.size(), result));
+            doNotOptimize(result);
+        }});
+    }
+    // Building the session is part of the call, as for a request handler. A
+    // full inline session is cut from the 50-set input, like the batch sessions.
+    const size_t inlineSets = sets == 50 ? InlineSession<>::INLINE_CAPACITY : sets;
+    if (inlineSets <= InlineSession<>::INLINE_CAPACITY) {
+        cases.push_back({"analyzeInlineSession", distribution, inlineSets, inlineSets * SET_BYTES,
+                         [s, inlineSets, &analyzer] {
+                             InlineSession<> session(s->durations.data(), s->intensities.data(), inlineSets);
+                             doNotOptimize(analyzer.analyze(session));
+                         }});
+    }
+    if (invalid) {
+        // Rejection path: the last set is out of range, so the whole input is scanned
+        cases.push_back({"tryAnalyze", distribution + "-invalid", sets, allBytes, [s, invalid, &analyzer] {
+            AnalysisResult result;
+            doNotOptimize(analyzer.tryAnalyze(s->durations, *invalid, result));
+        }});
+    }
+    cases.push_back({"validateInputs", distribution, sets, allBytes, [s] {
+        TennisAnalyzer::validateInputs(s->durations, s->intensities);
+        doNotOptimize(s->durations.data());
+    }});
+    cases.push_back({"calculateTotalActiveTime", distribution, sets, durationBytes, [s] {
+        doNotOptimize(TennisAnalyzer::calculateTotalActiveTime(s->durations));
+    }});
+    cases.push_back({"calculateWorkRestRatio", distribution, sets, durationBytes, [s] {
+        doNotOptimize(TennisAnalyzer::calculateWorkRestRatio(s->durations));
+    }});
+    cases.push_back({"calculateConsistencyScore", distribution, sets, allBytes, [s] {
+        doNotOptimize(TennisAnalyzer::calculateConsistencyScore(s->durations, s->intensities));
+    }});
+    cases.push_back({"calculateTrainingDensityScore", distribution, sets, allBytes, [s] {
+        doNotOptimize(TennisAnalyzer::calculateTrainingDensityScore(s->durations, s->intensities));
+    }});
+    if (batch.sessionCount() > 0) {
+        const SessionBatch* b = &batch;
+        BatchResult* out = &batchResult;
+        cases.push_back({"analyzeBatch", distribution, sets, allBytes, [b, out] {
+            analyzeBatch(*b, *out);
+            doNotOptimize(out->results.data());
+        }});
+
+        // A request's whole lifetime on one monotonic resource: copy the sets
+        // in, analyze, release. The arena is sized up front so nothing
+        // reaches the upstream (null) resource.
+        const size_t sessions = batch.sessionCount();
+        const size_t arenaBytes = batch.totalSetCount() * SET_BYTES +
+                                  sessions * (sizeof(size_t) + sizeof(AnalysisResult) + sizeof(std::pmr::string)) +
+                                  4096;
+        auto arena = std::make_shared<std::vector<std::byte>>(arenaBytes);
+        cases.push_back({"analyzeBatchPmr", distribution, sets, allBytes, [b, arena, sessions] {
+            std::pmr::monotonic_buffer_resource resource(arena->data(), arena->size(),
+                                                         std::pmr::null_memory_resource());
+            pmr::SessionBatch requestBatch(&resource);
+            requestBatch.reserve(sessions, b->totalSetCount());
+            for (size_t k = 0; k < sessions; ++k) {
+                requestBatch.addSession(b->durations(k), b->intensities(k), b->setCount(k));
+            }
+            pmr::BatchResult requestResult(&resource);
+            analyzeBatch(requestBatch, requestResult);
+            doNotOptimize(requestResult.results.data());
+        }});
+
+        // Packing the batch's results for a resident cache, one result per session
+        struct PackBuffers {
+            std::vector<AnalysisResult> results;
+            std::vector<PackedAnalysisResult> packed;
+            std::vector<AnalysisResult> unpacked;
+        };
+        auto buffers = std::make_shared<PackBuffers>();
+        buffers->results = analyzeBatch(batch).results;
+        buffers->packed.resize(sessions);
+        buffers->unpacked.resize(sessions);
+        packResults(buffers->results.data(), sessions, buffers->packed.data());
+        const size_t packBytes = sessions * (sizeof(AnalysisResult) + sizeof(PackedAnalysisResult));
+        cases.push_back({"packResults", distribution, sessions, packBytes, [buffers] {
+            packResults(buffers->results.data(), buffers->results.size(), buffers->packed.data());
+            doNotOptimize(buffers->packed.data());
+        }});
+        cases.push_back({"unpackResults", distribution, sessions, packBytes, [buffers] {
+            unpackResults(buffers->packed.data(), buffers->packed.size(), buffers->unpacked.data());
+            doNotOptimize(buffers->unpacked.data());
+        }});
+    }
+    return cases;
+}
+
+/**
+ * @brief Work that does not touch the library, timed at the start and end
+ * of a run so the regression gate can tell a slower host from slower code
+ *
+ * A dependent multiply-add chain over an L1-resident array: its time
+ * follows the core's clock and whatever else shares it, not memory or
+ * vector width.
+ */
+Case calibrationCase() {
+    constexpr size_t VALUES = 4096;
+    auto values = std::make_shared<std::vector<double>>(VALUES);
+    for (size_t i = 0; i < VALUES; ++i) {
+        (*values)[i] = static_cast<double>(i % 7) * 0.25;
+    }
+    return {CALIBRATION_KERNEL, "host", VALUES, VALUES * sizeof(double), [values] {
+        double chain = 0.0;
+        for (double value : *values) {
+            chain = chain * 0.999 + value;
+        }
+        doNotOptimize(chain);
+    }};
+}
+
+std::vector<size_t> sessionSizes(size_t maxSets) {
+    std::vector<size_t> sizes;
+    for (size_t n : {size_t(5), size_t(50), size_t(500), size_t(5000), size_t(50000),
+                     size_t(500000), size_t(1000000), size_t(10000000)}) {
+        if (n <= maxSets) {
+            sizes.push_back(n);
+        }
+    }
+    return sizes;
+}
+
+/**
+ * @brief Per-stage latency percentiles gathered while the benchmarks ran
+ */
+void printLatencySummary() {
+    const LatencySnapshot snapshot = latencySnapshot();
+    std::printf("\n%-24s %12s %10s %10s %10s %10s %12s\n",
+                "Stage", "Samples", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns");
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        const LatencyHistogram& h = snapshot[stage];
+        if (h.count() == 0) {
+            continue;
+        }
+        std::printf("%-24s %12llu %10llu %10llu %10llu %10llu %12llu\n", latencyStageName(stage),
+                    static_cast<unsigned long long>(h.count()),
+                    static_cast<unsigned long long>(h.valueAtPercentile(50.0)),
+                    static_cast<unsigned long long>(h.valueAtPercentile(90.0)),
+                    static_cast<unsigned long long>(h.valueAtPercentile(99.0)),
+                    static_cast<unsigned long long>(h.valueAtPercentile(99.9)),
+                    static_cast<unsigned long long>(h.max()));
+    }
+}
+
+/**
+ * @brief Allocations per instrumented API call (instrumentation builds)
+ */
+void printAllocationSummary() {
+    std::printf("\n%-24s %14s %14s %14s %12s\n", "Stage", "Calls", "Allocs/call", "Allocating", "Max/call");
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        const StageAllocationStats stats = stageAllocationStats(stage);
+        if (stats.calls == 0) {
+            continue;
+        }
+        std::printf("%-24s %14llu %14.4f %14llu %12llu\n", latencyStageName(stage),
+                    static_cast<unsigned long long>(stats.calls), stats.allocationsPerCall(),
+                    static_cast<unsigned long long>(stats.allocatingCalls),
+                    static_cast<unsigned long long>(stats.maxPerCall));
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --max-sets N     Largest session size to run (default 10000000)\n"
+              << "  --filter TEXT    Only run cases whose name contains TEXT\n"
+              << "  --min-time SEC   Minimum measured time per case (default 0.1)\n"
+              << "  --list           Print case names without running them\n"
+              << "  --repetitions N  Timed runs per case; the median is reported (default 1)\n"
+              << "  --rounds N       Run the whole suite N times with fresh inputs and report the\n"
+              << "                   median; the spread between rounds widens the noise margin\n"
+              << "                   (default 1)\n"
+              << "  --json FILE      Write results as JSON (usable as a baseline)\n"
+              << "  --baseline FILE  Compare against a JSON baseline; exit 1 if an analysis\n"
+              << "                   or packing kernel regressed\n"
+              << "  --tolerance PCT  Slowdown allowed per kernel, and per case before its\n"
+              << "                   noise margin (default 15)\n"
+              << "  --retries N      Re-measure a gated case over its limit up to N times (default 2)\n"
+              << "  --no-perf        Do not read hardware performance counters\n"
+              << "  --scaling        Measure batch throughput at 1..N threads instead\n"
+              << "  --threads N      Largest thread count for --scaling (default: all cores)\n"
+              << "  --sessions N     Sessions in the --scaling dataset (default 200000)\n"
+              << "  --csv FILE       Write the --scaling results as CSV\n"
+              << "  --trace FILE     Write a Chrome trace of the run (needs ENABLE_TRACING)\n"
+              << "  --allow-allocations  Do not fail when a zero-allocation kernel allocates\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool listOnly = false;
+    bool usePerf = true;
+    std::string tracePath;
+    bool allowAllocations = false;
+    std::string jsonPath;
+    std::string baselinePath;
+    RegressionPolicy policy;
+    bool scaling = false;
+    bool repetitionsGiven = false;
+    ScalabilityOptions scalabilityOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--max-sets") == 0 && hasValue) {
+            options.maxSets = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(arg, "--min-time") == 0 && hasValue) {
+            options.minTimeSeconds = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(arg, "--repetitions") == 0 && hasValue) {
+            options.repetitions = std::strtoull(argv[++i], nullptr, 10);
+            repetitionsGiven = true;
+        } else if (std::strcmp(arg, "--rounds") == 0 && hasValue) {
+            options.rounds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(arg, "--tolerance") == 0 && hasValue) {
+            policy.tolerance = std::strtod(argv[++i], nullptr) / 100.0;
+        } else if (std::strcmp(arg, "--retries") == 0 && hasValue) {
+            policy.retries = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--scaling") == 0) {
+            scaling = true;
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            scalabilityOptions.maxThreads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--sessions") == 0 && hasValue) {
+            scalabilityOptions.sessions = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--csv") == 0 && hasValue) {
+            scalabilityOptions.csvPath = argv[++i];
+        } else if (std::strcmp(arg, "--list") == 0) {
+            listOnly = true;
+        } else if (std::strcmp(arg, "--no-perf") == 0) {
+            usePerf = false;
+        } else if (std::strcmp(arg, "--allow-allocations") == 0) {
+            allowAllocations = true;
+        } else if (std::strcmp(arg, "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (scaling) {
+        if (repetitionsGiven) {
+            scalabilityOptions.repetitions = options.repetitions;
+        }
+        try {
+            runScalability(scalabilityOptions);
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Load the baseline first so a bad path fails before a long run
+    Baseline baseline;
+    if (!baselinePath.empty()) {
+        try {
+            baseline = loadBaseline(baselinePath);
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    PerfCounters perf;
+    PerfCounters* counters = usePerf && perf.available() ? &perf : nullptr;
+    if (!listOnly) {
+        if (usePerf && !counters) {
+            std::printf("Hardware counters unavailable (%s)\n", perf.error().c_str());
+        }
+        printHeader();
+    }
+    if (!tracePath.empty()) {
+        if (!TRACING_ENABLED) {
+            std::cerr << "--trace needs a build configured with -DENABLE_TRACING=ON\n";
+            return 1;
+        }
+        traceStart();
+    }
+
+    std::vector<Measurement> measurements;
+    std::vector<std::string> allocationFailures;
+    TennisAnalyzer analyzer;
+    const HostInfo host = describeHost();
+
+    // Host speed at the start of the run, for the retries; the gate uses
+    // the mean of the start and end measurements
+    const Case calibration = calibrationCase();
+    Measurement calibrationStart;
+    double speed = 1.0;
+    if (!listOnly) {
+        calibrationStart = run(calibration, options, counters);
+        speed = hostSpeedFactor(calibrationStart, baseline, host);
+    }
+    // Every round rebuilds its inputs, so drift across a run (allocation
+    // placement, cache history, host load) shows up as spread between rounds
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<Measurement>> rounds;
+    const size_t roundCount = listOnly ? 1 : std::max<size_t>(options.rounds, 1);
+    for (size_t round = 0; round < roundCount; ++round) {
+        if (roundCount > 1) {
+            std::printf("\nRound %zu of %zu\n", round + 1, roundCount);
+        }
+        for (size_t sets : sessionSizes(options.maxSets)) {
+            for (const char* distribution : DISTRIBUTIONS) {
+                // Inputs are built per size so 10M-set sessions are not all resident at once
+                const Session session = makeSession(distribution, sets);
+
+                // The batch variant splits the same sets into 32-set sessions
+                SessionBatch batch;
+                BatchResult batchResult;
+                if (sets >= BATCH_SESSION_SETS) {
+                    const size_t sessions = sets / BATCH_SESSION_SETS;
+                    batch.reserve(sessions, sessions * BATCH_SESSION_SETS);
+                    for (size_t k = 0; k < sessions; ++k) {
+                        batch.addSession(session.durations.data() + k * BATCH_SESSION_SETS,
+                                         session.intensities.data() + k * BATCH_SESSION_SETS,
+                                         BATCH_SESSION_SETS);
+                    }
+                }
+
+                // Invalid copy of the intensities for the rejection path (bounded to keep memory down)
+                std::vector<uint8_t> invalid;
+                if (sets <= MAX_INVALID_SETS) {
+                    invalid = session.intensities;
+                    invalid.back() = 0;
+                }
+
+                for (Case& benchmarkCase : makeCases(distribution, session, invalid.empty() ? nullptr : &invalid,
+                                                     batch, batchResult, analyzer)) {
+                    const bool batchCase =
+                        benchmarkCase.kernel == "analyzeBatch" || benchmarkCase.kernel == "analyzeBatchPmr";
+                    if (batch.sessionCount() > 0 && batchCase) {
+                        benchmarkCase.sets = batch.totalSetCount();
+                        benchmarkCase.bytesPerCall = batch.totalSetCount() * SET_BYTES;
+                    }
+                    const std::string name = benchmarkCase.name();
+                    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                        continue;
+                    }
+                    if (listOnly) {
+                        std::cout << name << "\n";
+                        continue;
+                    }
+                    Measurement m = run(benchmarkCase, options, counters);
+                    // A burst of host noise can push one measurement over the limit;
+                    // a real regression is still there when measured again
+                    for (size_t retry = 0; retry < policy.retries && overLimit(m, baseline, policy, speed);
+                         ++retry) {
+                        Measurement again = run(benchmarkCase, options, counters);
+                        if (again.nsPerCall < m.nsPerCall) {
+                            m = std::move(again);
+                        }
+                    }
+                    printMeasurement(m);
+                    std::vector<Measurement>& seen = rounds[name];
+                    if (seen.empty()) {
+                        order.push_back(name);
+                    }
+                    seen.push_back(m);
+                    if (benchmarkCase.expectZeroAllocations && m.allocsPerCall > 0.0) {
+                        std::printf("  FAIL: %s allocates %.2f times per call; it must not touch the heap\n",
+                                    name.c_str(), m.allocsPerCall);
+                        if (std::find(allocationFailures.begin(), allocationFailures.end(), name) ==
+                            allocationFailures.end()) {
+                            allocationFailures.push_back(name);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (roundCount > 1) {
+        std::printf("\nMedian over %zu rounds\n", roundCount);
+    }
+    for (const std::string& name : order) {
+        measurements.push_back(combineRounds(rounds[name]));
+        if (roundCount > 1) {
+            printMeasurement(measurements.back());
+        }
+    }
+
+    if (!listOnly) {
+        Measurement calibrated = run(calibration, options, counters);
+        calibrated.nsPerCall = std::sqrt(calibrationStart.nsPerCall * calibrated.nsPerCall);
+        calibrated.nsPerCallMad = std::max(calibrationStart.nsPerCallMad, calibrated.nsPerCallMad);
+        calibrated.nsPerSet = calibrated.nsPerCall / static_cast<double>(calibrated.sets);
+        printMeasurement(calibrated);
+        measurements.push_back(calibrated);
+    }
+
+    if (!tracePath.empty()) {
+        traceStop();
+        size_t events = writeChromeTraceFile(tracePath);
+        std::printf("\nWrote %zu trace events to %s (%llu dropped)\n", events, tracePath.c_str(),
+                    static_cast<unsigned long long>(traceDroppedEvents()));
+    }
+    if (LATENCY_HISTOGRAMS_ENABLED && !listOnly) {
+        printLatencySummary();
+    }
+    if (ALLOCATION_TRACKING_ENABLED && !listOnly) {
+        printAllocationSummary();
+    }
+
+    if (!jsonPath.empty() && !listOnly) {
+        try {
+            writeJsonReport(jsonPath, measurements, options, host);
+            std::printf("\nWrote %zu results to %s\n", measurements.size(), jsonPath.c_str());
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    int status = 0;
+    if (!allocationFailures.empty()) {
+        std::printf("\n%zu zero-allocation benchmark(s) allocated%s\n", allocationFailures.size(),
+                    allowAllocations ? " (allowed by --allow-allocations)" : "");
+        status = allowAllocations ? 0 : 1;
+    }
+    if (!baselinePath.empty() && !listOnly) {
+        const size_t regressions = compareWithBaseline(measurements, baseline, policy, host);
+        if (regressions > 0) {
+            std::printf("\n%zu kernel(s) regressed against %s\n", regressions, baselinePath.c_str());
+            status = 1;
+        } else {
+            std::printf("\nNo regressions against %s\n", baselinePath.c_str());
+        }
+    }
+    return status;
+}
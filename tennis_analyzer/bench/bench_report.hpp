@@ -0,0 +1,379 @@
+//
+//  bench_report.hpp
+//  Tennis Analyzer Benchmarks
+//
+//  JSON results and regression checks against a stored baseline
+//
+
+#ifndef TENNIS_BENCH_REPORT_HPP
+#define TENNIS_BENCH_REPORT_HPP
+
+#include "bench_harness.hpp"
+#include "json_reader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/utsname.h>
+
+namespace tennis {
+namespace bench {
+
+constexpr int REPORT_SCHEMA_VERSION = 1;
+
+// Kernel of the library-independent case that measures the host's speed
+constexpr const char* CALIBRATION_KERNEL = "calibration";
+
+/**
+ * @brief The machine a report was recorded on
+ */
+struct HostInfo {
+    std::string cpu;         // Model name from /proc/cpuinfo, if readable
+    unsigned cpus = 0;       // Logical CPUs
+    bool virtualized = false; // The CPU reports a hypervisor
+    std::string kernel;      // uname release
+
+    /// Same processor model and CPU count, so times are directly comparable
+    bool sameMachine(const HostInfo& other) const {
+        return cpu == other.cpu && cpus == other.cpus && virtualized == other.virtualized;
+    }
+};
+
+inline HostInfo describeHost() {
+    HostInfo host;
+    host.cpus = std::thread::hardware_concurrency();
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        const std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        if (key == "model name" && host.cpu.empty()) {
+            host.cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+        } else if (key == "flags" && line.find(" hypervisor") != std::string::npos) {
+            host.virtualized = true;
+        }
+    }
+    utsname name;
+    if (uname(&name) == 0) {
+        host.kernel = name.release;
+    }
+    return host;
+}
+
+inline std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+    }
+    return escaped;
+}
+
+/**
+ * @brief Write measurements as JSON
+ *
+ * @code
+ *   {"schema": 1, "repetitions": 5, "rounds": 3, "minTimeSeconds": 0.1,
+ *    "host": {"cpu": "...", "cpus": 8, "virtualized": false, "kernel": "6.1.0"},
+ *    "benchmarks": [{"name": "analyze/uniform/500", "kernel": "analyze",
+ *                    "sets": 500, "iterations": 9000, "repetitions": 5,
+ *                    "nsPerCall": 812.4, "nsPerCallMad": 3.1, "nsPerSet": 1.62,
+ *                    "allocsPerCall": 0}, ...]}
+ * @endcode
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+inline void writeJsonReport(const std::string& path, const std::vector<Measurement>& measurements,
+                            const Options& options, const HostInfo& host) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path + " for writing");
+    }
+    std::fprintf(file, "{\n  \"schema\": %d,\n  \"repetitions\": %zu,\n  \"rounds\": %zu,\n  \"minTimeSeconds\": %g,\n",
+                 REPORT_SCHEMA_VERSION, options.repetitions, options.rounds, options.minTimeSeconds);
+    std::fprintf(file, "  \"host\": {\"cpu\": \"%s\", \"cpus\": %u, \"virtualized\": %s, \"kernel\": \"%s\"},\n",
+                 jsonEscape(host.cpu).c_str(), host.cpus, host.virtualized ? "true" : "false",
+                 jsonEscape(host.kernel).c_str());
+    std::fprintf(file, "  \"benchmarks\": [");
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        const Measurement& m = measurements[i];
+        // Case names are built from identifiers and numbers, so need no escaping
+        std::fprintf(file,
+                     "%s\n    {\"name\": \"%s\", \"kernel\": \"%s\", \"sets\": %zu, \"iterations\": %llu, "
+                     "\"repetitions\": %zu, \"nsPerCall\": %.6g, \"nsPerCallMad\": %.6g, \"nsPerSet\": %.6g, "
+                     "\"allocsPerCall\": %.6g}",
+                     i == 0 ? "" : ",", m.name.c_str(), m.kernel.c_str(), m.sets,
+                     static_cast<unsigned long long>(m.iterations), m.repetitions,
+                     m.nsPerCall, m.nsPerCallMad, m.nsPerSet, m.allocsPerCall);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+struct BaselineEntry {
+    double nsPerCall = 0.0;
+    double nsPerCallMad = 0.0;
+};
+
+/**
+ * @brief Stored results and the machine they were recorded on
+ */
+struct Baseline {
+    std::unordered_map<std::string, BaselineEntry> entries;
+    HostInfo host;
+    bool hasHost = false; // Reports from before the host was recorded lack it
+
+    /// Entry for `name`, or nullptr if there is none with a usable time
+    const BaselineEntry* find(const std::string& name) const {
+        const auto found = entries.find(name);
+        return found != entries.end() && found->second.nsPerCall > 0.0 ? &found->second : nullptr;
+    }
+};
+
+/**
+ * @brief Load a report written by writeJsonReport
+ *
+ * Only the host and each benchmark's name, nsPerCall and nsPerCallMad are
+ * read; other members are ignored.
+ *
+ * @throws std::runtime_error if the file is missing or malformed
+ */
+inline Baseline loadBaseline(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open baseline " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string text = contents.str();
+
+    Baseline baseline;
+    JsonReader reader(text.data(), text.size());
+    std::string_view key;
+    bool ok = reader.beginObject();
+    while (ok && reader.nextMember(key)) {
+        if (key == "host") {
+            ok = reader.beginObject();
+            while (ok && reader.nextMember(key)) {
+                std::string_view text;
+                double number = 0.0;
+                if (key == "cpu") {
+                    ok = reader.readString(text);
+                    baseline.host.cpu = std::string(text);
+                } else if (key == "cpus") {
+                    ok = reader.readNumber(number);
+                    baseline.host.cpus = static_cast<unsigned>(number);
+                } else if (key == "virtualized") {
+                    ok = reader.readBool(baseline.host.virtualized);
+                } else if (key == "kernel") {
+                    ok = reader.readString(text);
+                    baseline.host.kernel = std::string(text);
+                } else {
+                    ok = reader.skipValue();
+                }
+            }
+            baseline.hasHost = true;
+            continue;
+        }
+        if (key != "benchmarks") {
+            ok = reader.skipValue();
+            continue;
+        }
+        ok = reader.beginArray();
+        while (ok && reader.nextElement()) {
+            std::string_view name;
+            BaselineEntry entry;
+            ok = reader.beginObject();
+            while (ok && reader.nextMember(key)) {
+                if (key == "name") {
+                    ok = reader.readString(name);
+                } else if (key == "nsPerCall") {
+                    ok = reader.readNumber(entry.nsPerCall);
+                } else if (key == "nsPerCallMad") {
+                    ok = reader.readNumber(entry.nsPerCallMad);
+                } else {
+                    ok = reader.skipValue();
+                }
+            }
+            if (ok && !name.empty()) {
+                baseline.entries[std::string(name)] = entry;
+            }
+        }
+    }
+    if (!ok || !reader.finish()) {
+        throw std::runtime_error("Malformed baseline " + path);
+    }
+    return baseline;
+}
+
+/**
+ * @brief Thresholds for calling a slowdown a regression
+ *
+ * When the baseline was recorded on a different machine, its times are
+ * first scaled by the host speed factor, the ratio of the calibration case
+ * now to its baseline, so a machine that is slower overall does not read as
+ * a regression. A case is then slower when its
+ * median exceeds
+ *   baseline * (1 + tolerance) + madMultiplier * (baselineMad + currentMad)
+ * A gated kernel regresses when the geometric mean of its cases' ratios
+ * exceeds
+ *   1 + tolerance + madMultiplier * (median relative MAD of its cases)
+ * so both decisions widen with the noise that was actually measured.
+ */
+struct RegressionPolicy {
+    double tolerance = 0.15;
+    double madMultiplier = 3.0;
+    size_t retries = 2; // Re-measurements of a gated case over its limit; the fastest counts
+    std::vector<std::string> gatedKernels{"analyze", "tryAnalyze", "analyzeInline", "analyzeInlineSession",
+                                          "analyzeBatch", "analyzeBatchPmr", "packResults", "unpackResults"};
+
+    bool gates(const std::string& kernel) const {
+        for (const std::string& gated : gatedKernels) {
+            if (gated == kernel) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Slowest median a measurement may have against its baseline entry
+ *
+ * @param speed Host speed factor; baseline times are scaled by it
+ */
+inline double regressionLimit(const BaselineEntry& base, const Measurement& m, const RegressionPolicy& policy,
+                              double speed = 1.0) {
+    return speed * base.nsPerCall * (1.0 + policy.tolerance) +
+           policy.madMultiplier * (speed * base.nsPerCallMad + m.nsPerCallMad);
+}
+
+/**
+ * @brief How much slower this host runs the calibration case than the
+ * baseline's host did
+ *
+ * 1 on the machine that recorded the baseline: there the calibration case
+ * drifts between runs about as much as the kernels, but not in step with
+ * them, so scaling by it would only add noise. Drift on one machine is left
+ * to the noise terms. Also 1 if either side has no calibration.
+ */
+inline double hostSpeedFactor(const Measurement& calibration, const Baseline& baseline, const HostInfo& host) {
+    const BaselineEntry* base = baseline.find(calibration.name);
+    if (!base || calibration.nsPerCall <= 0.0 || (baseline.hasHost && baseline.host.sameMachine(host))) {
+        return 1.0;
+    }
+    return calibration.nsPerCall / base->nsPerCall;
+}
+
+/**
+ * @brief True when a gated measurement is over its limit; false for cases
+ * that are not gated or have no baseline
+ */
+inline bool overLimit(const Measurement& m, const Baseline& baseline, const RegressionPolicy& policy,
+                      double speed = 1.0) {
+    if (!policy.gates(m.kernel)) {
+        return false;
+    }
+    const BaselineEntry* base = baseline.find(m.name);
+    return base && m.nsPerCall > regressionLimit(*base, m, policy, speed);
+}
+
+/**
+ * @brief Print each measurement next to its baseline, then the geometric
+ * mean change per gated kernel against that kernel's limit
+ *
+ * @return Number of gated kernels that regressed
+ */
+inline size_t compareWithBaseline(const std::vector<Measurement>& measurements, const Baseline& baseline,
+                                  const RegressionPolicy& policy, const HostInfo& host) {
+    double speed = 1.0;
+    for (const Measurement& m : measurements) {
+        if (m.kernel == CALIBRATION_KERNEL) {
+            speed = hostSpeedFactor(m, baseline, host);
+        }
+    }
+    if (baseline.hasHost && baseline.host.sameMachine(host)) {
+        std::printf("\nSame machine as the baseline (%s, %u CPUs); times are compared directly\n",
+                    host.cpu.c_str(), host.cpus);
+    } else {
+        std::printf("\nBaseline recorded on %s; host speed factor %.3f (calibration now / in the baseline) "
+                    "scales its times\n",
+                    baseline.hasHost ? baseline.host.cpu.c_str() : "an unrecorded machine", speed);
+    }
+    std::printf("\n%-48s %14s %14s %9s %9s  %s\n", "Benchmark", "baseline ns", "current ns", "change", "limit",
+                "status");
+    std::printf("%s\n", std::string(106, '-').c_str());
+
+    std::vector<double> logRatioSums(policy.gatedKernels.size(), 0.0);
+    std::vector<std::vector<double>> relativeNoise(policy.gatedKernels.size());
+    for (const Measurement& m : measurements) {
+        if (m.kernel == CALIBRATION_KERNEL) {
+            continue;
+        }
+        const BaselineEntry* found = baseline.find(m.name);
+        if (!found) {
+            std::printf("%-48s %14s %14.1f %9s %9s  %s\n", m.name.c_str(), "-", m.nsPerCall, "-", "-",
+                        "no baseline");
+            continue;
+        }
+        const BaselineEntry& base = *found;
+        const double expected = speed * base.nsPerCall;
+        const double limit = regressionLimit(base, m, policy, speed);
+        const double change = (m.nsPerCall / expected - 1.0) * 100.0;
+        const double limitChange = (limit / expected - 1.0) * 100.0;
+
+        for (size_t k = 0; k < policy.gatedKernels.size(); ++k) {
+            if (policy.gatedKernels[k] == m.kernel) {
+                logRatioSums[k] += std::log(m.nsPerCall / expected);
+                relativeNoise[k].push_back((speed * base.nsPerCallMad + m.nsPerCallMad) / expected);
+            }
+        }
+
+        const char* status = "ok";
+        if (!policy.gates(m.kernel)) {
+            status = m.nsPerCall > limit ? "slower (not gated)" : "ok (not gated)";
+        } else if (m.nsPerCall > limit) {
+            status = "slower";
+        }
+        std::printf("%-48s %14.1f %14.1f %+8.1f%% %+8.1f%%  %s\n", m.name.c_str(), expected, m.nsPerCall,
+                    change, limitChange, status);
+    }
+
+    std::printf("\n");
+    size_t regressions = 0;
+    for (size_t k = 0; k < policy.gatedKernels.size(); ++k) {
+        const size_t compared = relativeNoise[k].size();
+        if (compared == 0) {
+            continue;
+        }
+        const double geomean = std::exp(logRatioSums[k] / static_cast<double>(compared));
+        const double limit = 1.0 + policy.tolerance + policy.madMultiplier * median(relativeNoise[k]);
+        const bool regressed = geomean > limit;
+        regressions += regressed ? 1 : 0;
+        std::printf("%-24s %+6.1f%% geometric mean over %zu cases, limit %+.1f%%%s\n",
+                    policy.gatedKernels[k].c_str(), (geomean - 1.0) * 100.0, compared, (limit - 1.0) * 100.0,
+                    regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+} // namespace bench
+} // namespace tennis
+
+#endif // TENNIS_BENCH_REPORT_HPP
@@ -0,0 +1,149 @@
+//
+//  perf_counters.hpp
+//  Tennis Analyzer Benchmarks
+//
+//  Hardware performance counters via Linux perf_event_open
+//
+
+#ifndef TENNIS_BENCH_PERF_COUNTERS_HPP
+#define TENNIS_BENCH_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace tennis {
+namespace bench {
+
+/**
+ * @brief User-space cycles, instructions, cache misses and branch misses
+ *
+ * Each event is opened on its own (not as a group), so a PMU that lacks
+ * one event still reports the others. Counts are scaled when the kernel
+ * multiplexes counters. Where perf_event_open is missing or refused
+ * (non-Linux, containers, perf_event_paranoid > 2, VMs without a virtual
+ * PMU), available() is false and the harness reports n/a.
+ */
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, CacheMisses, BranchMisses, EVENT_COUNT };
+
+    struct Reading {
+        double values[EVENT_COUNT] = {0.0, 0.0, 0.0, 0.0};
+        bool valid[EVENT_COUNT] = {false, false, false, false};
+    };
+
+    PerfCounters() {
+#if defined(__linux__)
+        static const uint64_t configs[EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[i] < 0 && error_.empty()) {
+                error_ = std::string("perf_event_open: ") + std::strerror(errno);
+            }
+        }
+#else
+        error_ = "perf_event_open is Linux only";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Why the first unavailable event could not be opened
+     */
+    const std::string& error() const { return error_; }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Counts since the last start(), scaled for multiplexing
+     */
+    Reading read() const {
+        Reading reading;
+#if defined(__linux__)
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            uint64_t data[3]; // value, time enabled, time running
+            if (fds_[i] < 0 || ::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) ||
+                data[2] == 0) {
+                continue;
+            }
+            reading.values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                                static_cast<double>(data[2]);
+            reading.valid[i] = true;
+        }
+#endif
+        return reading;
+    }
+
+private:
+    int fds_[EVENT_COUNT] = {-1, -1, -1, -1};
+    std::string error_;
+};
+
+} // namespace bench
+} // namespace tennis
+
+#endif // TENNIS_BENCH_PERF_COUNTERS_HPP
@@ -0,0 +1,275 @@
+//
+//  scalability.hpp
+//  Tennis Analyzer Benchmarks
+//
+//  Thread-count scaling of batch analysis over a fixed synthetic dataset,
+//  for columnar (SoA) and record (AoS) session layouts
+//
+
+#ifndef TENNIS_BENCH_SCALABILITY_HPP
+#define TENNIS_BENCH_SCALABILITY_HPP
+
+#include "analysis_kernels.hpp"
+#include "bench_harness.hpp"
+#include "scratch_arena.hpp"
+#include "session_batch.hpp"
+#include "tennis_analyzer.hpp"
+#include "workload_generator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tennis {
+namespace bench {
+
+struct ScalabilityOptions {
+    size_t maxThreads = 0;       // 0 = std::thread::hardware_concurrency()
+    size_t sessions = 200000;    // Dataset size; ~24 sets per session on average
+    size_t repetitions = 3;      // Timed passes per point; the median is reported
+    uint64_t seed = 42;
+    std::string csvPath;         // Optional CSV output for plotting
+};
+
+/**
+ * @brief One set in the record (array-of-structures) layout
+ */
+struct SetRecord {
+    double duration;
+    uint8_t intensity;
+};
+
+/**
+ * @brief The dataset in the record layout: one SetRecord array plus offsets
+ */
+struct RecordDataset {
+    std::vector<SetRecord> sets;
+    std::vector<size_t> offsets{0};
+
+    size_t sessionCount() const { return offsets.size() - 1; }
+};
+
+inline RecordDataset toRecords(const SessionBatch& batch) {
+    RecordDataset records;
+    records.sets.reserve(batch.totalSetCount());
+    records.offsets.reserve(batch.sessionCount() + 1);
+    for (size_t s = 0; s < batch.sessionCount(); ++s) {
+        for (size_t i = 0; i < batch.setCount(s); ++i) {
+            records.sets.push_back({batch.durations(s)[i], batch.intensities(s)[i]});
+        }
+        records.offsets.push_back(records.sets.size());
+    }
+    return records;
+}
+
+/**
+ * @brief analyzeBatchRange for the record layout
+ */
+inline size_t analyzeRecordRange(const RecordDataset& records, size_t first, size_t last, BatchResult& out) {
+    // Transposed sets are scratch for this range only
+    ScratchArena& arena = threadScratchArena();
+    ScratchArena::Scope scratch(arena);
+    std::pmr::vector<double> durations(&arena);
+    std::pmr::vector<uint8_t> intensities(&arena);
+    TennisAnalyzer analyzer;
+    size_t failed = 0;
+
+    for (size_t s = first; s < last; ++s) {
+        durations.clear();
+        intensities.clear();
+        for (size_t i = records.offsets[s]; i < records.offsets[s + 1]; ++i) {
+            durations.push_back(records.sets[i].duration);
+            intensities.push_back(records.sets[i].intensity);
+        }
+        out.errors[s].clear();
+        ValidationResult validation =
+            analyzer.tryAnalyze(durations.data(), intensities.data(), durations.size(), out.results[s]);
+        if (!validation.ok()) {
+            analysis::appendValidationMessage(out.errors[s], validation);
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+/**
+ * @brief Time one pass over `sessions` sessions on `threads` threads
+ *
+ * Workers claim fixed-size chunks of sessions from a shared cursor, so
+ * uneven session sizes do not leave threads idle. Timing starts once
+ * every worker is running.
+ */
+inline double timeParallelPass(size_t threads, size_t sessions,
+                               const std::function<void(size_t, size_t)>& analyzeRange) {
+    constexpr size_t CHUNK_SESSIONS = 256;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+
+    auto work = [&] {
+        while (true) {
+            const size_t first = next.fetch_add(CHUNK_SESSIONS, std::memory_order_relaxed);
+            if (first >= sessions) {
+                return;
+            }
+            analyzeRange(first, std::min(first + CHUNK_SESSIONS, sessions));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back([&] {
+            ready.fetch_add(1, std::memory_order_release);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            work();
+        });
+    }
+    while (ready.load(std::memory_order_acquire) < threads - 1) {
+        std::this_thread::yield();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    work(); // The calling thread is worker 0
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief 1, 2, 4, ... up to and including maxThreads
+ */
+inline std::vector<size_t> threadCounts(size_t maxThreads) {
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+struct ScalingPoint {
+    std::string layout;
+    size_t threads;
+    double seconds;
+    double setsPerSecond;
+    double speedup;
+    double efficiency;
+    double gigabytesPerSecond;
+};
+
+/**
+ * @brief Run the scaling study and print one row per layout and thread count
+ *
+ * Bandwidth is an estimate: input bytes of the layout (set data plus
+ * session offsets) and result bytes written, divided by the pass time.
+ *
+ * @throws std::runtime_error if the CSV file cannot be written
+ */
+inline void runScalability(const ScalabilityOptions& options) {
+    const size_t maxThreads = options.maxThreads > 0
+        ? options.maxThreads
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    WorkloadConfig config;
+    config.seed = options.seed;
+    SessionBatch batch;
+    WorkloadGenerator(config).fillBatch(batch, options.sessions);
+    const RecordDataset records = toRecords(batch);
+
+    const size_t sessions = batch.sessionCount();
+    const size_t sets = batch.totalSetCount();
+    const double offsetBytes = static_cast<double>(sessions + 1) * sizeof(size_t);
+    const double resultBytes = static_cast<double>(sessions) * sizeof(AnalysisResult);
+
+    struct Layout {
+        const char* name;
+        double inputBytes;
+        std::function<void(size_t, size_t, BatchResult&)> analyzeRange;
+    };
+    const Layout layouts[] = {
+        {"soa", static_cast<double>(sets) * (sizeof(double) + sizeof(uint8_t)) + offsetBytes,
+         [&batch](size_t first, size_t last, BatchResult& out) { analyzeBatchRange(batch, first, last, out); }},
+        {"aos", static_cast<double>(sets) * sizeof(SetRecord) + offsetBytes,
+         [&records](size_t first, size_t last, BatchResult& out) { analyzeRecordRange(records, first, last, out); }},
+    };
+
+    std::printf("Scalability: %zu sessions, %zu sets, up to %zu threads, median of %zu passes\n",
+                sessions, sets, maxThreads, options.repetitions);
+    std::printf("%-8s %8s %12s %14s %10s %11s %12s\n",
+                "Layout", "Threads", "ms/pass", "Msets/s", "Speedup", "Efficiency", "GB/s (est)");
+    std::printf("%s\n", std::string(81, '-').c_str());
+
+    std::vector<ScalingPoint> points;
+    BatchResult out;
+    for (const Layout& layout : layouts) {
+        double singleThreadSeconds = 0.0;
+        size_t knee = 1;  // Largest thread count before efficiency first drops below 80%
+        bool scaling = true;
+        for (size_t threads : threadCounts(maxThreads)) {
+            prepareBatchResult(batch, out);
+            auto range = [&](size_t first, size_t last) { layout.analyzeRange(first, last, out); };
+            timeParallelPass(threads, sessions, range); // Warm-up: page in the dataset and thread scratch
+
+            std::vector<double> samples;
+            for (size_t r = 0; r < std::max<size_t>(options.repetitions, 1); ++r) {
+                samples.push_back(timeParallelPass(threads, sessions, range));
+            }
+            const double seconds = median(samples);
+            if (threads == 1) {
+                singleThreadSeconds = seconds;
+            }
+
+            ScalingPoint point;
+            point.layout = layout.name;
+            point.threads = threads;
+            point.seconds = seconds;
+            point.setsPerSecond = static_cast<double>(sets) / seconds;
+            point.speedup = singleThreadSeconds / seconds;
+            point.efficiency = point.speedup / static_cast<double>(threads);
+            point.gigabytesPerSecond = (layout.inputBytes + resultBytes) / seconds / 1e9;
+            points.push_back(point);
+            scaling = scaling && point.efficiency >= 0.8;
+            if (scaling) {
+                knee = threads;
+            }
+
+            std::printf("%-8s %8zu %12.2f %14.2f %10.2f %10.0f%% %12.2f\n", layout.name, threads,
+                        seconds * 1e3, point.setsPerSecond / 1e6, point.speedup, point.efficiency * 100.0,
+                        point.gigabytesPerSecond);
+            std::fflush(stdout);
+        }
+        std::printf("%-8s efficiency stays at or above 80%% up to %zu thread(s)\n\n", layout.name, knee);
+    }
+
+    if (!options.csvPath.empty()) {
+        std::FILE* file = std::fopen(options.csvPath.c_str(), "w");
+        if (!file) {
+            throw std::runtime_error("Failed to open " + options.csvPath + " for writing");
+        }
+        std::fprintf(file, "layout,threads,seconds,sets_per_second,speedup,efficiency,gb_per_second\n");
+        for (const ScalingPoint& p : points) {
+            std::fprintf(file, "%s,%zu,%.9g,%.9g,%.6g,%.6g,%.6g\n", p.layout.c_str(), p.threads, p.seconds,
+                         p.setsPerSecond, p.speedup, p.efficiency, p.gigabytesPerSecond);
+        }
+        if (std::fclose(file) != 0) {
+            throw std::runtime_error("Failed to write " + options.csvPath);
+        }
+        std::printf("Wrote %zu points to %s\n", points.size(), options.csvPath.c_str());
+    }
+}
+
+} // namespace bench
+} // namespace tennis
+
+#endif // TENNIS_BENCH_SCALABILITY_HPP
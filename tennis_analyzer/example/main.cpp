@@ -4,12 +4,23 @@
 //
 
 #include "tennis_analyzer.hpp"
+#include "constexpr_analysis.hpp"
+#include <array>
 #include <iostream>
 #include <iomanip>
 #include <vector>
 
 using namespace tennis;
 
+// Training template scored at compile time: 5 sets of 5 minutes at moderate intensity
+constexpr std::array<double, 5> TEMPLATE_DURATIONS = {300.0, 300.0, 300.0, 300.0, 300.0};
+constexpr std::array<uint8_t, 5> TEMPLATE_INTENSITIES = {3, 3, 3, 3, 3};
+constexpr AnalysisResult TEMPLATE_PREVIEW = compile_time::analyze(TEMPLATE_DURATIONS, TEMPLATE_INTENSITIES);
+
+static_assert(TEMPLATE_PREVIEW.totalActiveTime == 1500.0, "5 x 300 s");
+static_assert(TEMPLATE_PREVIEW.consistencyScore == 1.0, "identical sets are perfectly consistent");
+static_assert(TEMPLATE_PREVIEW.averageIntensity == 3.0, "all sets at intensity 3");
+
 void printAnalysisResult(const AnalysisResult& result) {
     std::cout << "\n=== Training Session Analysis ===\n";
     std::cout << std::fixed << std::setprecision(2);
@@ -88,6 +99,10 @@ int main() {
     std::cout << "Consistency Score: " << consistency << "\n";
     std::cout << "Training Density Score: " << density << "\n";
     
+    // Example 5: Template scored at compile time
+    std::cout << "\n--- Example 5: Compile-Time Template Preview ---\n";
+    printAnalysisResult(TEMPLATE_PREVIEW);
+    
     return 0;
 }
 
@@ -0,0 +1,822 @@
+//
+//  differential_fuzz.cpp
+//  Tennis Analyzer Fuzzing
+//
+//  Differential fuzzing of every analysis path against the reference
+//  scalar implementation. Builds as a libFuzzer target with
+//  TENNIS_LIBFUZZER=1, otherwise as a seeded standalone driver.
+//
+
+#include "analysis_kernels.hpp"
+#include "analysis_service.hpp"
+#include "constexpr_analysis.hpp"
+#include "header_only_kernels.hpp"
+#include "kernel_dispatch.hpp"
+#include "packed_result.hpp"
+#include "reference_analyzer.hpp"
+#include "session_batch.hpp"
+#include "tennis_analyzer.hpp"
+#include "tennis_analyzer_c.h"
+#include "workload_generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef TENNIS_LIBFUZZER
+#define TENNIS_LIBFUZZER 0
+#endif
+
+namespace {
+
+using namespace tennis;
+
+// MARK: - ULP comparison
+
+/**
+ * @brief Distance in units in the last place between two doubles
+ *
+ * Both NaN counts as equal (0); NaN against a number, or infinities of
+ * different sign, as the maximum distance. -0.0 and +0.0 are 0 apart.
+ */
+uint64_t ulpDistance(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b) ? 0 : std::numeric_limits<uint64_t>::max();
+    }
+    if (a == b) {
+        return 0;
+    }
+    // Map the sign-magnitude bit patterns onto a monotonic unsigned scale
+    auto ordered = [](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits >> 63) ? ~bits + 1 : bits | (uint64_t(1) << 63);
+    };
+    const uint64_t x = ordered(a);
+    const uint64_t y = ordered(b);
+    return x > y ? x - y : y - x;
+}
+
+/**
+ * @brief Largest ULP distance a path may show from the reference, per metric
+ *
+ * Every path below evaluates the same operations in the same order as the
+ * reference, so all of them are held to exact (0 ULP) agreement,
+ * including NaN and infinity propagation. A future path that reorders a
+ * reduction (SIMD lanes, split or parallel sums) must declare bounds that
+ * cover the reassociation error for the session sizes it accepts, and
+ * document them here.
+ *
+ * The one exception is trainingDensityScore on intensity scales other than
+ * 1-5 (densityUlpBound).
+ */
+struct UlpBounds {
+    uint64_t totalActiveTime = 0;
+    uint64_t workRestRatio = 0;
+    uint64_t consistencyScore = 0;
+    uint64_t trainingDensityScore = 0;
+    uint64_t averageIntensity = 0;
+    uint64_t totalWorkVolume = 0;
+};
+
+/**
+ * @brief What a path produced for one session: a result, or a validation error
+ */
+struct PathOutput {
+    AnalysisResult result;
+    std::string error; // Empty when the session was analyzed
+};
+
+/**
+ * @brief One implementation under test
+ *
+ * `validates` paths reject invalid sessions with the reference message;
+ * kernel paths are only fed sessions with matching column sizes.
+ */
+struct Path {
+    const char* name;
+    UlpBounds bounds;
+    bool validates;
+    std::function<PathOutput(const std::vector<double>&, const std::vector<uint8_t>&)> run;
+};
+
+struct Session {
+    std::vector<double> durations;
+    std::vector<uint8_t> intensities;
+};
+
+const uint8_t* currentInput = nullptr;
+size_t currentInputSize = 0;
+
+void describeSession(const Session& session) {
+    std::fprintf(stderr, "  session: %zu durations, %zu intensities\n", session.durations.size(),
+                 session.intensities.size());
+    const size_t shown = std::min<size_t>(session.durations.size(), 16);
+    for (size_t i = 0; i < shown; ++i) {
+        std::fprintf(stderr, "    [%zu] duration %.17g intensity %d\n", i, session.durations[i],
+                     i < session.intensities.size() ? session.intensities[i] : -1);
+    }
+}
+
+[[noreturn]] void reportMismatch(const char* path, const char* what, const std::string& expected,
+                                 const std::string& actual, const Session& session) {
+    std::fprintf(stderr, "\nDifferential mismatch in %s: %s\n  reference: %s\n  actual:    %s\n", path, what,
+                 expected.c_str(), actual.c_str());
+    describeSession(session);
+    if (!TENNIS_LIBFUZZER && currentInput) {
+        std::ofstream("differential-failure.bin", std::ios::binary)
+            .write(reinterpret_cast<const char*>(currentInput), static_cast<std::streamsize>(currentInputSize));
+        std::fprintf(stderr, "  input written to differential-failure.bin\n");
+    }
+    std::abort(); // libFuzzer saves the crashing input
+}
+
+std::string formatDouble(double value) {
+    char text[40];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+void expectClose(const char* path, const char* metric, double expected, double actual, uint64_t bound,
+                 const Session& session) {
+    const uint64_t distance = ulpDistance(expected, actual);
+    if (distance > bound) {
+        reportMismatch(path, metric, formatDouble(expected),
+                       formatDouble(actual) + " (" + std::to_string(distance) + " ULP, bound " +
+                           std::to_string(bound) + ")",
+                       session);
+    }
+}
+
+void expectSameResult(const Path& path, const AnalysisResult& expected, const AnalysisResult& actual,
+                      const Session& session) {
+    const UlpBounds& b = path.bounds;
+    expectClose(path.name, "totalActiveTime", expected.totalActiveTime, actual.totalActiveTime,
+                b.totalActiveTime, session);
+    expectClose(path.name, "workRestRatio", expected.workRestRatio, actual.workRestRatio, b.workRestRatio, session);
+    expectClose(path.name, "consistencyScore", expected.consistencyScore, actual.consistencyScore,
+                b.consistencyScore, session);
+    expectClose(path.name, "trainingDensityScore", expected.trainingDensityScore, actual.trainingDensityScore,
+                b.trainingDensityScore, session);
+    expectClose(path.name, "averageIntensity", expected.averageIntensity, actual.averageIntensity,
+                b.averageIntensity, session);
+    expectClose(path.name, "totalWorkVolume", expected.totalWorkVolume, actual.totalWorkVolume,
+                b.totalWorkVolume, session);
+    if (expected.totalSets != actual.totalSets) {
+        reportMismatch(path.name, "totalSets", std::to_string(expected.totalSets), std::to_string(actual.totalSets),
+                       session);
+    }
+}
+
+// MARK: - Paths under test
+
+PathOutput fromBatch(const BatchResult& out, size_t session) {
+    return {out.results[session], out.errors[session]};
+}
+
+// compile_time::analyze is instantiated for every session size up to this
+constexpr size_t CONSTEXPR_MAX_SETS = 16;
+
+using FixedAnalyzer = AnalysisResult (*)(const double*, const uint8_t*);
+
+template <size_t N>
+AnalysisResult analyzeFixed(const double* durations, const uint8_t* intensities) {
+    std::array<double, N> d{};
+    std::array<uint8_t, N> i{};
+    std::copy_n(durations, N, d.begin());
+    std::copy_n(intensities, N, i.begin());
+    return compile_time::analyze(d, i);
+}
+
+template <size_t... N>
+std::array<FixedAnalyzer, sizeof...(N)> fixedAnalyzers(std::index_sequence<N...>) {
+    return {{&analyzeFixed<N>...}};
+}
+
+const std::vector<Path>& paths() {
+    static const std::vector<Path> all = {
+        {"TennisAnalyzer::tryAnalyze", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             PathOutput output;
+             ValidationResult validation = TennisAnalyzer().tryAnalyze(d, i, output.result);
+             if (!validation.ok()) {
+                 output.error = TennisAnalyzer::validationMessage(validation);
+             }
+             return output;
+         }},
+        {"TennisAnalyzer::analyze", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             PathOutput output;
+             try {
+                 output.result = TennisAnalyzer().analyze(d, i);
+             } catch (const std::invalid_argument& e) {
+                 output.error = e.what();
+             }
+             return output;
+         }},
+        {"TennisAnalyzer::analyze (InlineSession)", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             // A small inline capacity, so sessions cross over to the heap
+             // while being built and the copy lands in either storage
+             InlineSession<8> built;
+             for (size_t k = 0; k < d.size(); ++k) {
+                 built.addSet(d[k], i[k]);
+             }
+             const InlineSession<8> session = built;
+             PathOutput output;
+             try {
+                 output.result = TennisAnalyzer().analyze(session);
+             } catch (const std::invalid_argument& e) {
+                 output.error = e.what();
+             }
+             return output;
+         }},
+        {"static calculate* kernels", {}, false,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             // Unvalidated: the kernels must match the reference on any equal-length input
+             PathOutput output;
+             output.result = reference::analyze(d, i);
+             output.result.totalActiveTime = TennisAnalyzer::calculateTotalActiveTime(d);
+             output.result.workRestRatio = TennisAnalyzer::calculateWorkRestRatio(d);
+             output.result.consistencyScore = TennisAnalyzer::calculateConsistencyScore(d, i);
+             output.result.trainingDensityScore = TennisAnalyzer::calculateTrainingDensityScore(d, i);
+             return output;
+         }},
+        {"analyzeBatch", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)}; // Not representable
+             }
+             // Surround the session with neighbours so offsets are exercised
+             thread_local SessionBatch batch;
+             thread_local BatchResult out;
+             const double neighbour[] = {60.0, 120.0, 90.0};
+             const uint8_t neighbourIntensity[] = {2, 4, 3};
+             batch.clear();
+             batch.addSession(neighbour, neighbourIntensity, 3);
+             batch.addSession(d.data(), i.data(), d.size());
+             batch.addSession(neighbour, neighbourIntensity, 2);
+             analyzeBatch(batch, out);
+             return fromBatch(out, 1);
+         }},
+        {"analyzeBatchRange", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             // The session twice, analyzed as two separate ranges
+             thread_local SessionBatch batch;
+             thread_local BatchResult out;
+             batch.clear();
+             batch.addSession(d.data(), i.data(), d.size());
+             batch.addSession(d.data(), i.data(), d.size());
+             prepareBatchResult(batch, out);
+             analyzeBatchRange(batch, 1, 2, out);
+             analyzeBatchRange(batch, 0, 1, out);
+             if (out.errors[0] != out.errors[1]) {
+                 return PathOutput{AnalysisResult{}, "ranges disagree: " + out.errors[0] + " / " + out.errors[1]};
+             }
+             return fromBatch(out, 0);
+         }},
+        {"analyzeBatch (pmr)", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             // One monotonic resource per call, released with everything in it
+             std::pmr::monotonic_buffer_resource resource;
+             pmr::SessionBatch batch(&resource);
+             const double neighbour[] = {60.0, 120.0, 90.0};
+             const uint8_t neighbourIntensity[] = {2, 4, 3};
+             batch.addSession(neighbour, neighbourIntensity, 3);
+             batch.addSession(d.data(), i.data(), d.size());
+             const pmr::BatchResult out = analyzeBatch(batch);
+             if (out.get_allocator().resource() != &resource) {
+                 return PathOutput{AnalysisResult{}, "results not allocated from the batch's resource"};
+             }
+             return PathOutput{out.results[1], std::string(out.errors[1])};
+         }},
+        {"tennis_analyze (C)", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             static tennis_analyzer* analyzer = tennis_analyzer_create();
+             tennis_analysis_result result;
+             size_t index = 0;
+             const tennis_status status = tennis_analyze(analyzer, d.data(), i.data(), d.size(), &result, &index);
+             PathOutput output;
+             if (status == TENNIS_OK) {
+                 output.result = {result.total_active_time, result.work_rest_ratio, result.consistency_score,
+                                  result.training_density_score, result.average_intensity,
+                                  result.total_work_volume, static_cast<size_t>(result.total_sets)};
+             } else {
+                 ValidationResult validation;
+                 validation.status = status == TENNIS_ERROR_DURATION_OUT_OF_RANGE ? ValidationStatus::DurationOutOfRange
+                                                                                   : ValidationStatus::IntensityOutOfRange;
+                 validation.index = index;
+                 output.error = status == TENNIS_ERROR_DURATION_OUT_OF_RANGE ||
+                                        status == TENNIS_ERROR_INTENSITY_OUT_OF_RANGE
+                                    ? TennisAnalyzer::validationMessage(validation)
+                                    : tennis_status_message(status);
+             }
+             return output;
+         }},
+        {"analysis::tryAnalyze", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             PathOutput output;
+             ValidationResult validation = analysis::tryAnalyze(d.data(), i.data(), d.size(), output.result);
+             if (!validation.ok()) {
+                 output.error = TennisAnalyzer::validationMessage(validation);
+             }
+             return output;
+         }},
+        {"analysis::tryAnalyze (header-only)", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             PathOutput output;
+             ValidationResult validation = fuzz::tryAnalyzeHeaderOnly(d.data(), i.data(), d.size(), output.result);
+             if (!validation.ok()) {
+                 output.error = TennisAnalyzer::validationMessage(validation);
+             }
+             return output;
+         }},
+        {"compile_time::analyze", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size() || d.size() > CONSTEXPR_MAX_SETS) {
+                 // Not representable: sizes are fixed per instantiation
+                 return PathOutput{reference::analyze(d, i), reference::validationError(d, i)};
+             }
+             static const auto analyzers = fixedAnalyzers(std::make_index_sequence<CONSTEXPR_MAX_SETS + 1>());
+             PathOutput output;
+             try {
+                 output.result = analyzers[d.size()](d.data(), i.data());
+             } catch (const std::invalid_argument& e) {
+                 output.error = e.what();
+             }
+             return output;
+         }},
+        {"AnalysisService::analyze", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             static AnalysisService service;
+             PathOutput output;
+             try {
+                 output.result = service.analyze(d, i);
+             } catch (const std::invalid_argument& e) {
+                 output.error = e.what();
+             }
+             return output;
+         }},
+        {"AnalysisService::analyze (InlineSession)", {}, true,
+         [](const std::vector<double>& d, const std::vector<uint8_t>& i) {
+             if (d.size() != i.size()) {
+                 return PathOutput{AnalysisResult{}, reference::validationError(d, i)};
+             }
+             static AnalysisService service;
+             InlineSession<> session(d.data(), i.data(), d.size());
+             const InlineSession<> moved = std::move(session);
+             PathOutput output;
+             try {
+                 output.result = service.analyze(moved);
+             } catch (const std::invalid_argument& e) {
+                 output.error = e.what();
+             }
+             return output;
+         }},
+    };
+    return all;
+}
+
+/**
+ * @brief Check every ISA variant of the scanning kernels, not just the one
+ * this CPU would select
+ */
+void checkKernelTables(const Session& session) {
+    const std::vector<double>& d = session.durations;
+    const std::vector<uint8_t>& in = session.intensities;
+
+    size_t expectedDuration = d.size();
+    for (size_t i = 0; i < d.size(); ++i) {
+        if (d[i] < 0.0 || d[i] > 86400.0) {
+            expectedDuration = i;
+            break;
+        }
+    }
+    size_t expectedIntensity = in.size();
+    uint64_t expectedSum = 0;
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (expectedIntensity == in.size() && (in[i] < 1 || in[i] > 5)) {
+            expectedIntensity = i;
+        }
+        expectedSum += in[i];
+    }
+
+    static const std::vector<const KernelTable*> tables = supportedKernelTables();
+    for (const KernelTable* table : tables) {
+        const std::string name = std::string("kernels/") + table->isa;
+        const size_t duration = table->findDurationOutOfRange(d.data(), d.size(), 0.0, 86400.0);
+        if (duration != expectedDuration) {
+            reportMismatch(name.c_str(), "findDurationOutOfRange", std::to_string(expectedDuration),
+                           std::to_string(duration), session);
+        }
+        const size_t intensity = table->findIntensityOutOfRange(in.data(), in.size(), 1, 5);
+        if (intensity != expectedIntensity) {
+            reportMismatch(name.c_str(), "findIntensityOutOfRange", std::to_string(expectedIntensity),
+                           std::to_string(intensity), session);
+        }
+        const uint64_t sum = table->sumIntensities(in.data(), in.size());
+        if (sum != expectedSum) {
+            reportMismatch(name.c_str(), "sumIntensities", std::to_string(expectedSum), std::to_string(sum), session);
+        }
+    }
+}
+
+/**
+ * @brief Every ISA variant of packResults/unpackResults must produce the
+ * bytes and values of packResult/unpackResult, on real results and on raw
+ * durations standing in for every field; a real result must round-trip
+ * within the bounds documented on PackedAnalysisResult
+ */
+void checkPackedResults(const Session& session, const AnalysisResult* expected) {
+    std::vector<AnalysisResult> results;
+    if (expected) {
+        results.push_back(*expected);
+    }
+    for (double value : session.durations) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        results.push_back({value, value, value, value, value, value, static_cast<size_t>(bits)});
+    }
+
+    std::vector<PackedAnalysisResult> expectedPacked(results.size());
+    std::vector<AnalysisResult> expectedUnpacked(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        expectedPacked[i] = packResult(results[i]);
+        expectedUnpacked[i] = unpackResult(expectedPacked[i]);
+    }
+
+    static const std::vector<const KernelTable*> tables = supportedKernelTables();
+    std::vector<PackedAnalysisResult> packed(results.size());
+    std::vector<AnalysisResult> unpacked(results.size());
+    for (const KernelTable* table : tables) {
+        const std::string name = std::string("kernels/") + table->isa;
+        table->packResults(results.data(), results.size(), packed.data());
+        table->unpackResults(expectedPacked.data(), expectedPacked.size(), unpacked.data());
+        const Path path{name.c_str(), {}, false, nullptr};
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (std::memcmp(&packed[i], &expectedPacked[i], sizeof(PackedAnalysisResult)) != 0) {
+                reportMismatch(name.c_str(), "packResults", "packResult() bytes",
+                               "different bytes for result " + std::to_string(i), session);
+            }
+            expectSameResult(path, expectedUnpacked[i], unpacked[i], session);
+        }
+    }
+
+    if (!expected) {
+        return;
+    }
+    const AnalysisResult& r = *expected;
+    const AnalysisResult& u = expectedUnpacked[0];
+    const auto expectWithin = [&](const char* metric, double original, double actual, double bound) {
+        if (!(std::abs(actual - original) <= bound) && !(std::isnan(original) && std::isnan(actual))) {
+            reportMismatch("packResult round trip", metric, formatDouble(original),
+                           formatDouble(actual) + " (bound " + formatDouble(bound) + ")", session);
+        }
+    };
+    const double floatEpsilon = std::ldexp(1.0, -24);
+    const auto floatBound = [&](double value) { return std::max(std::abs(value) * floatEpsilon, std::ldexp(1.0, -150)); };
+    expectWithin("totalActiveTime", r.totalActiveTime, u.totalActiveTime, floatBound(r.totalActiveTime));
+    expectWithin("totalWorkVolume", r.totalWorkVolume, u.totalWorkVolume, floatBound(r.totalWorkVolume));
+    expectWithin("consistencyScore", r.consistencyScore, u.consistencyScore, 7.7e-6);
+    expectWithin("trainingDensityScore", r.trainingDensityScore, u.trainingDensityScore, 7.7e-6);
+    expectWithin("averageIntensity", r.averageIntensity, u.averageIntensity, 0.001);
+    if (std::abs(r.workRestRatio) < 65504.0) {
+        // Relative below 2^-14, where halves turn subnormal, absolute under it
+        const double bound = std::max(std::abs(r.workRestRatio) * (std::ldexp(1.0, -11) + floatEpsilon),
+                                      std::ldexp(1.0, -25));
+        expectWithin("workRestRatio", r.workRestRatio, u.workRestRatio, bound);
+    } else if (std::abs(r.workRestRatio) >= 65520.0 && !std::isinf(u.workRestRatio)) {
+        reportMismatch("packResult round trip", "workRestRatio", "infinity", formatDouble(u.workRestRatio), session);
+    }
+    if (u.totalSets != r.totalSets) {
+        reportMismatch("packResult round trip", "totalSets", std::to_string(r.totalSets),
+                       std::to_string(u.totalSets), session);
+    }
+}
+
+/**
+ * @brief compile_time::sqrt must equal std::sqrt bit for bit, including on
+ * the NaN, infinite, negative and subnormal durations of raw inputs
+ */
+void checkConstexprSqrt(const Session& session) {
+    for (double value : session.durations) {
+        for (double x : {value, std::abs(value), value * value}) {
+            const double expected = std::sqrt(x);
+            const double actual = compile_time::sqrt(x);
+            if (std::memcmp(&expected, &actual, sizeof(double)) != 0 &&
+                !(std::isnan(expected) && std::isnan(actual))) {
+                reportMismatch("compile_time::sqrt", ("sqrt(" + formatDouble(x) + ")").c_str(),
+                               formatDouble(expected), formatDouble(actual), session);
+            }
+        }
+    }
+}
+
+/**
+ * @brief ULP bound on trainingDensityScore for an n-set session on a scale
+ * other than 1-5
+ *
+ * The reference averages n normalized levels, each rounded once, with a
+ * front-to-back sum: at most (n + 1) roundings of relative size 2^-53 on a
+ * sum of non-negative terms. The kernels sum the integer levels exactly
+ * and divide once. The average therefore differs by at most (n + 2) ULP
+ * relative to itself, and since every density weight is non-negative it
+ * moves the weighted sum by no more than that, plus one ULP for each of
+ * its few roundings. On 1-5 the normalized levels are multiples of 1/4, so
+ * both sums are exact and the bound is 0.
+ */
+uint64_t densityUlpBound(size_t sets) {
+    return static_cast<uint64_t>(sets) + 8;
+}
+
+/**
+ * @brief The scale-templated kernels on one intensity scale, for the
+ * session as given and with its intensities folded into the scale's range
+ */
+template <typename Scale>
+void checkIntensityScale(const char* name, const Session& session) {
+    if (session.durations.size() != session.intensities.size()) {
+        return;
+    }
+    const reference::IntensityRange range{Scale::MIN, Scale::MAX};
+    UlpBounds bounds;
+    if (Scale::MIN != 1 || Scale::MAX != 5) {
+        bounds.trainingDensityScore = densityUlpBound(session.durations.size());
+    }
+    const Path path{name, bounds, true, nullptr};
+
+    Session folded = session;
+    for (uint8_t& level : folded.intensities) {
+        level = static_cast<uint8_t>(Scale::MIN + level % (Scale::MAX - Scale::MIN + 1));
+    }
+    const Session* inputs[] = {&session, &folded};
+    for (const Session* input : inputs) {
+        const std::vector<double>& d = input->durations;
+        const std::vector<uint8_t>& i = input->intensities;
+        const std::string expectedError = reference::validationError(d, i, range);
+
+        AnalysisResult result;
+        const ValidationResult validation = analysis::tryAnalyze<Scale>(d.data(), i.data(), d.size(), result);
+        const std::string error = analysis::validationMessage<Scale>(validation);
+        if (error != expectedError) {
+            reportMismatch(name, "validation", expectedError.empty() ? "(valid)" : expectedError,
+                           error.empty() ? "(valid)" : error, *input);
+        }
+        if (expectedError.empty()) {
+            expectSameResult(path, reference::analyze(d, i, ScoringConfig::defaults(), range), result, *input);
+        }
+    }
+}
+
+/**
+ * @brief Run one session through every path and compare with the reference
+ */
+void checkSession(const Session& session) {
+    const std::string expectedError = reference::validationError(session.durations, session.intensities);
+    const bool sameLength = session.durations.size() == session.intensities.size();
+    const AnalysisResult expected = sameLength ? reference::analyze(session.durations, session.intensities)
+                                               : AnalysisResult{};
+
+    for (const Path& path : paths()) {
+        if (!path.validates && !sameLength) {
+            continue;
+        }
+        const PathOutput output = path.run(session.durations, session.intensities);
+        if (path.validates && output.error != expectedError) {
+            reportMismatch(path.name, "validation", expectedError.empty() ? "(valid)" : expectedError,
+                           output.error.empty() ? "(valid)" : output.error, session);
+        }
+        if (!path.validates || expectedError.empty()) {
+            expectSameResult(path, expected, output.result, session);
+        }
+    }
+    checkKernelTables(session);
+    checkPackedResults(session, sameLength && expectedError.empty() ? &expected : nullptr);
+    checkConstexprSqrt(session);
+    checkIntensityScale<RpeScale>("analysis::tryAnalyze<RpeScale>", session);
+    checkIntensityScale<PercentScale>("analysis::tryAnalyze<PercentScale>", session);
+}
+
+// MARK: - Input decoding
+
+/**
+ * @brief Turn fuzzer bytes into a session
+ *
+ * Byte 0 selects the encoding:
+ * - bit 0: durations are raw IEEE-754 bit patterns (NaN, infinities,
+ *   subnormals, negative zero) instead of values scaled into [-1000, 89000]
+ * - bit 1: drop the last intensity to produce a size mismatch
+ * - bit 2: map intensity bytes into [1, 5] so most sessions pass validation
+ * Each set then takes 9 bytes: 8 for the duration, 1 for the intensity.
+ */
+Session decodeSession(const uint8_t* data, size_t size) {
+    Session session;
+    if (size == 0) {
+        return session;
+    }
+    const uint8_t mode = data[0];
+    const bool rawDurations = mode & 1;
+    const bool mismatch = mode & 2;
+    const bool validIntensities = mode & 4;
+
+    for (size_t offset = 1; offset + 9 <= size; offset += 9) {
+        uint64_t bits;
+        std::memcpy(&bits, data + offset, sizeof(bits));
+        double duration;
+        if (rawDurations) {
+            std::memcpy(&duration, &bits, sizeof(duration));
+        } else {
+            duration = static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0) * 90000.0 - 1000.0;
+        }
+        const uint8_t intensity = data[offset + 8];
+        session.durations.push_back(duration);
+        session.intensities.push_back(validIntensities ? static_cast<uint8_t>(1 + intensity % 5) : intensity);
+    }
+    if (mismatch && !session.intensities.empty()) {
+        session.intensities.pop_back();
+    }
+    return session;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    currentInput = data;
+    currentInputSize = size;
+    checkSession(decodeSession(data, size));
+    currentInput = nullptr;
+    return 0;
+}
+
+#if !TENNIS_LIBFUZZER
+
+namespace {
+
+/**
+ * @brief Hand-picked sessions at the edges of the kernels' arithmetic
+ */
+std::vector<Session> adversarialSessions() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const double denormal = std::numeric_limits<double>::denorm_min();
+
+    std::vector<Session> sessions = {
+        {{}, {}},                                          // Empty
+        {{300.0}, {3}},                                    // Single set
+        {{0.0, 0.0, 0.0}, {1, 1, 1}},                      // Zero mean: CV short-circuit
+        {{-0.0, 0.0}, {5, 5}},                             // Signed zeros
+        {{1e-10, 2e-10}, {1, 5}},                          // Mean just below EPSILON
+        {{1e-9, 1e-9}, {2, 2}},                            // Mean at EPSILON
+        {{denormal, denormal * 3}, {1, 2}},                // Subnormals
+        {{86400.0, 86400.0, 86400.0}, {5, 5, 5}},          // Upper bound, long-set penalty
+        {{29.999999999999996, 30.0}, {3, 3}},              // Short-set threshold
+        {{1800.0, 1800.0000000000002}, {4, 4}},            // Long-set threshold
+        {{nan, 300.0}, {3, 3}},                            // NaN passes validation
+        {{300.0, nan}, {0, 3}},                            // NaN then invalid intensity
+        {{inf, 1.0}, {3, 3}},                              // Infinite duration is rejected
+        {{-1e-300, 1.0}, {3, 3}},                          // Tiny negative is rejected
+        {{86400.00000000001}, {3}},                        // Just above the range
+        {{300.0, 200.0}, {3, 6}},                          // Intensity above range
+        {{300.0, 200.0}, {3}},                             // Size mismatch
+        {{1.0, 86400.0, 1.0, 86400.0}, {1, 5, 1, 5}},      // Alternating extremes
+    };
+
+    // Long sessions where summation order matters most
+    Session large;
+    WorkloadRandom random(7);
+    for (size_t i = 0; i < 100000; ++i) {
+        large.durations.push_back(random.uniform() * 86400.0);
+        large.intensities.push_back(static_cast<uint8_t>(random.uniformInt(1, 5)));
+    }
+    sessions.push_back(large);
+
+    Session mixedMagnitude;
+    for (size_t i = 0; i < 4096; ++i) {
+        mixedMagnitude.durations.push_back(i % 2 ? 86400.0 : 1e-7);
+        mixedMagnitude.intensities.push_back(static_cast<uint8_t>(1 + i % 5));
+    }
+    sessions.push_back(mixedMagnitude);
+    return sessions;
+}
+
+/**
+ * @brief Random byte strings, decoded like fuzzer inputs
+ */
+std::vector<uint8_t> randomInput(WorkloadRandom& random, size_t maxSets) {
+    const size_t sets = static_cast<size_t>(random.uniformInt(0, maxSets));
+    std::vector<uint8_t> bytes(1 + sets * 9);
+    for (uint8_t& byte : bytes) {
+        byte = static_cast<uint8_t>(random.next());
+    }
+    return bytes;
+}
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options] [input files...]\n"
+                "  --seed N         Seed for generated inputs (default 1)\n"
+                "  --iterations N   Random inputs to generate (default 100000)\n"
+                "  --max-sets N     Largest generated session (default 64)\n"
+                "Input files (e.g. differential-failure.bin) are replayed instead of generating.\n",
+                program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t seed = 1;
+    uint64_t iterations = 100000;
+    size_t maxSets = 64;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--iterations") == 0 && hasValue) {
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--max-sets") == 0 && hasValue) {
+            maxSets = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg[0] == '-') {
+            printUsage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (!files.empty()) {
+        for (const std::string& file : files) {
+            std::ifstream in(file, std::ios::binary);
+            if (!in) {
+                std::fprintf(stderr, "Cannot read %s\n", file.c_str());
+                return 1;
+            }
+            const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+        }
+        std::printf("Replayed %zu input(s): all paths match the reference\n", files.size());
+        return 0;
+    }
+
+    const std::vector<Session> adversarial = adversarialSessions();
+    for (const Session& session : adversarial) {
+        checkSession(session);
+    }
+
+    // Structured sessions from the workload generator, including invalid records
+    WorkloadConfig config;
+    config.seed = seed;
+    config.invalidRate = 0.02;
+    WorkloadGenerator generator(config);
+    GeneratedSession generated;
+    const uint64_t generatedCount = iterations / 10;
+    for (uint64_t i = 0; i < generatedCount; ++i) {
+        generator.generate(i, generated);
+        checkSession({generated.durations, generated.intensities});
+    }
+
+    WorkloadRandom random(seed);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        const std::vector<uint8_t> bytes = randomInput(random, maxSets);
+        LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+    }
+
+    std::printf("%zu adversarial, %llu generated and %llu random sessions: %zu paths match the reference\n",
+                adversarial.size(), static_cast<unsigned long long>(generatedCount),
+                static_cast<unsigned long long>(iterations), paths().size());
+    return 0;
+}
+
+#endif // !TENNIS_LIBFUZZER
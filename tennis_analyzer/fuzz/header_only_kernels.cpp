@@ -0,0 +1,24 @@
+//
+//  header_only_kernels.cpp
+//  Tennis Analyzer Fuzzing
+//
+//  Built with TENNIS_ANALYZER_HEADER_ONLY=1 (see CMakeLists.txt)
+//
+
+#include "header_only_kernels.hpp"
+#include "analysis_kernels.hpp"
+
+#if !TENNIS_ANALYZER_HEADER_ONLY
+#error "header_only_kernels.cpp must be compiled with TENNIS_ANALYZER_HEADER_ONLY=1"
+#endif
+
+namespace tennis {
+namespace fuzz {
+
+ValidationResult tryAnalyzeHeaderOnly(const double* durations, const uint8_t* intensities, size_t count,
+                                      AnalysisResult& result) {
+    return analysis::tryAnalyze(durations, intensities, count, result);
+}
+
+} // namespace fuzz
+} // namespace tennis
@@ -0,0 +1,30 @@
+//
+//  header_only_kernels.hpp
+//  Tennis Analyzer Fuzzing
+//
+//  Entry point into analysis_kernels.hpp as built header-only, compiled in
+//  its own translation unit so the harness can compare it with the
+//  library's dispatched build of the same kernels
+//
+
+#ifndef TENNIS_FUZZ_HEADER_ONLY_KERNELS_HPP
+#define TENNIS_FUZZ_HEADER_ONLY_KERNELS_HPP
+
+#include "tennis_analyzer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tennis {
+namespace fuzz {
+
+/**
+ * @brief analysis::tryAnalyze with TENNIS_ANALYZER_HEADER_ONLY=1 and the default configuration
+ */
+ValidationResult tryAnalyzeHeaderOnly(const double* durations, const uint8_t* intensities, size_t count,
+                                      AnalysisResult& result);
+
+} // namespace fuzz
+} // namespace tennis
+
+#endif // TENNIS_FUZZ_HEADER_ONLY_KERNELS_HPP
@@ -0,0 +1,179 @@
+//
+//  reference_analyzer.hpp
+//  Tennis Analyzer Fuzzing
+//
+//  Straightforward scalar transcription of the original analysis
+//  semantics, used as the oracle for differential testing
+//
+
+#ifndef TENNIS_FUZZ_REFERENCE_ANALYZER_HPP
+#define TENNIS_FUZZ_REFERENCE_ANALYZER_HPP
+
+#include "tennis_analyzer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace tennis {
+namespace reference {
+
+// Written for clarity, not speed: intensities are widened to doubles, every
+// statistic is a separate pass and sums run front to back. Do not optimize.
+
+/**
+ * @brief Valid intensity levels; {1, 5} is the original scale
+ */
+struct IntensityRange {
+    uint8_t min = 1;
+    uint8_t max = 5;
+};
+
+inline double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+inline double standardDeviation(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    const double m = mean(values);
+    double sumSquaredDiff = 0.0;
+    for (double value : values) {
+        const double diff = value - m;
+        sumSquaredDiff += diff * diff;
+    }
+    return std::sqrt(sumSquaredDiff / static_cast<double>(values.size() - 1));
+}
+
+inline double coefficientOfVariation(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const double m = mean(values);
+    if (std::abs(m) < 1e-9) {
+        return 0.0;
+    }
+    return standardDeviation(values) / m;
+}
+
+inline double normalizeIntensity(uint8_t intensity, IntensityRange range = {}) {
+    return static_cast<double>(intensity - range.min) / static_cast<double>(range.max - range.min);
+}
+
+inline double totalActiveTime(const std::vector<double>& durations) {
+    return std::accumulate(durations.begin(), durations.end(), 0.0);
+}
+
+inline double workRestRatio(const std::vector<double>& durations) {
+    if (durations.empty()) {
+        return 0.0;
+    }
+    const double total = totalActiveTime(durations);
+    if (total < 1e-9) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return total / total;
+}
+
+inline double consistencyScore(const std::vector<double>& durations, const std::vector<uint8_t>& intensities,
+                               const ScoringConfig& config = ScoringConfig::defaults()) {
+    if (durations.size() < 2) {
+        return 1.0;
+    }
+    const double durationConsistency = 1.0 / (1.0 + coefficientOfVariation(durations));
+    const std::vector<double> intensityDoubles(intensities.begin(), intensities.end());
+    const double intensityConsistency = 1.0 / (1.0 + coefficientOfVariation(intensityDoubles));
+    const double consistency = config.durationConsistencyWeight * durationConsistency +
+                               config.intensityConsistencyWeight * intensityConsistency;
+    return std::max(0.0, std::min(1.0, consistency));
+}
+
+inline double trainingDensityScore(const std::vector<double>& durations, const std::vector<uint8_t>& intensities,
+                                   const ScoringConfig& config = ScoringConfig::defaults(),
+                                   IntensityRange range = {}) {
+    if (durations.empty()) {
+        return 0.0;
+    }
+    // The original formula: a sum of normalized levels. The kernels sum the
+    // integer levels and divide once; on 1-5 every term here is a multiple
+    // of 1/4, so both are exact and agree bit for bit (see densityUlpBound
+    // in the harness for other scales).
+    double avgIntensity = 0.0;
+    for (uint8_t intensity : intensities) {
+        avgIntensity += normalizeIntensity(intensity, range);
+    }
+    avgIntensity /= static_cast<double>(intensities.size());
+
+    double totalWorkVolume = 0.0;
+    for (size_t i = 0; i < durations.size(); ++i) {
+        totalWorkVolume += durations[i] * normalizeIntensity(intensities[i], range);
+    }
+
+    const double avgDuration = mean(durations);
+    const double volumeComponent =
+        std::min(1.0, totalWorkVolume / (config.volumeReferenceDuration * durations.size()));
+    double durationComponent = 1.0;
+    if (avgDuration < config.shortSetThreshold) {
+        durationComponent = avgDuration / config.shortSetThreshold;
+    } else if (avgDuration > config.longSetThreshold) {
+        durationComponent = config.longSetThreshold / avgDuration;
+    }
+
+    const double density = config.densityIntensityWeight * avgIntensity +
+                           config.densityVolumeWeight * volumeComponent +
+                           config.densityDurationWeight * durationComponent;
+    return std::max(0.0, std::min(1.0, density));
+}
+
+/**
+ * @brief The original validateInputs checks, returning the exception
+ * message it threw (empty for valid input)
+ */
+inline std::string validationError(const std::vector<double>& durations, const std::vector<uint8_t>& intensities,
+                                   IntensityRange range = {}) {
+    if (durations.size() != intensities.size()) {
+        return "Durations and intensities vectors must have the same size";
+    }
+    for (size_t i = 0; i < durations.size(); ++i) {
+        if (durations[i] < 0.0 || durations[i] > 86400.0) {
+            return "Duration at index " + std::to_string(i) + " is out of valid range [0, 86400] seconds";
+        }
+    }
+    for (size_t i = 0; i < intensities.size(); ++i) {
+        if (intensities[i] < range.min || intensities[i] > range.max) {
+            return "Intensity at index " + std::to_string(i) + " is out of valid range [" +
+                   std::to_string(range.min) + ", " + std::to_string(range.max) + "]";
+        }
+    }
+    return "";
+}
+
+inline AnalysisResult analyze(const std::vector<double>& durations, const std::vector<uint8_t>& intensities,
+                              const ScoringConfig& config = ScoringConfig::defaults(), IntensityRange range = {}) {
+    AnalysisResult result;
+    result.totalActiveTime = durations.empty() ? 0.0 : totalActiveTime(durations);
+    result.workRestRatio = workRestRatio(durations);
+    result.consistencyScore = consistencyScore(durations, intensities, config);
+    result.trainingDensityScore = trainingDensityScore(durations, intensities, config, range);
+    result.totalSets = durations.size();
+    result.averageIntensity = std::accumulate(intensities.begin(), intensities.end(), 0.0) /
+                              static_cast<double>(intensities.size());
+    result.totalWorkVolume = 0.0;
+    for (size_t i = 0; i < durations.size(); ++i) {
+        result.totalWorkVolume += durations[i] * static_cast<double>(intensities[i]);
+    }
+    return result;
+}
+
+} // namespace reference
+} // namespace tennis
+
+#endif // TENNIS_FUZZ_REFERENCE_ANALYZER_HPP
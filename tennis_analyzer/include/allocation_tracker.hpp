@@ -0,0 +1,98 @@
+//
+//  allocation_tracker.hpp
+//  Tennis Training Session Analyzer
+//
+//  Heap allocation counting for instrumentation builds
+//  (TENNIS_ANALYZER_TRACK_ALLOCATIONS=1)
+//
+
+#ifndef TENNIS_ALLOCATION_TRACKER_HPP
+#define TENNIS_ALLOCATION_TRACKER_HPP
+
+#include "tennis_export.h"
+#include "latency_histogram.hpp"
+#include <cstdint>
+
+#ifndef TENNIS_ANALYZER_TRACK_ALLOCATIONS
+#define TENNIS_ANALYZER_TRACK_ALLOCATIONS 0
+#endif
+
+namespace tennis {
+
+constexpr bool ALLOCATION_TRACKING_ENABLED = TENNIS_ANALYZER_TRACK_ALLOCATIONS != 0;
+
+/**
+ * @brief Allocations made through global operator new
+ */
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief Allocations attributed to one instrumented API call site
+ *
+ * Sites are the LatencyStage values. Counts are inclusive: analyze()
+ * includes what its validation and metric functions allocate.
+ */
+struct StageAllocationStats {
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t allocatingCalls = 0; // Calls that allocated at least once
+    uint64_t maxPerCall = 0;
+
+    double allocationsPerCall() const {
+        return calls ? static_cast<double>(allocations) / static_cast<double>(calls) : 0.0;
+    }
+};
+
+#if TENNIS_ANALYZER_TRACK_ALLOCATIONS
+
+/**
+ * @brief Allocations made by the calling thread since it started
+ */
+TENNIS_API AllocationCounts threadAllocationCounts();
+
+/**
+ * @brief Allocations made by all threads since the process started
+ */
+TENNIS_API AllocationCounts processAllocationCounts();
+
+TENNIS_API StageAllocationStats stageAllocationStats(LatencyStage stage);
+
+TENNIS_API void resetAllocationStats();
+
+/**
+ * @brief Attributes the calling thread's allocations in this scope to `stage`
+ */
+class TENNIS_API AllocationScope {
+public:
+    explicit AllocationScope(LatencyStage stage);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    LatencyStage stage_;
+    AllocationCounts start_;
+};
+
+#define TENNIS_ALLOCATION_SCOPE(stage) \
+    ::tennis::AllocationScope tennisAllocationScope_(::tennis::LatencyStage::stage)
+
+#else
+
+inline AllocationCounts threadAllocationCounts() { return {}; }
+inline AllocationCounts processAllocationCounts() { return {}; }
+inline StageAllocationStats stageAllocationStats(LatencyStage) { return {}; }
+inline void resetAllocationStats() {}
+
+#define TENNIS_ALLOCATION_SCOPE(stage) ((void)0)
+
+#endif // TENNIS_ANALYZER_TRACK_ALLOCATIONS
+
+} // namespace tennis
+
+#endif // TENNIS_ALLOCATION_TRACKER_HPP
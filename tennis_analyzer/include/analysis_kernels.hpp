@@ -0,0 +1,531 @@
+//
+//  analysis_kernels.hpp
+//  Tennis Training Session Analyzer
+//
+//  The analysis arithmetic as inline functions over pointer/count inputs.
+//  TennisAnalyzer is built on these; callers can use them directly so a
+//  whole analysis inlines into the call site, e.g. for fixed set counts.
+//  Intensity-dependent kernels are templated on an IntensityScale and
+//  default to the 1-5 scale.
+//
+//  With TENNIS_ANALYZER_HEADER_ONLY=1 this header has no link-time
+//  dependency on the library: input scans are compiled inline for the
+//  caller's target instead of dispatched per ISA by the library. Both
+//  modes give identical results.
+//
+
+#ifndef TENNIS_ANALYSIS_KERNELS_HPP
+#define TENNIS_ANALYSIS_KERNELS_HPP
+
+#include "intensity_scale.hpp"
+#include "scoring_config.hpp"
+#include "tennis_analyzer.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+
+#ifndef TENNIS_ANALYZER_HEADER_ONLY
+#define TENNIS_ANALYZER_HEADER_ONLY 0
+#endif
+
+#if TENNIS_ANALYZER_HEADER_ONLY
+#include "scan_kernels.hpp"
+#else
+#include "kernel_dispatch.hpp"
+#endif
+
+namespace tennis {
+namespace analysis {
+
+// The two modes define the same functions differently; separate inline
+// namespaces keep translation units built in different modes from
+// violating the one-definition rule when linked together.
+#if TENNIS_ANALYZER_HEADER_ONLY
+inline namespace header_only {
+#else
+inline namespace dispatched {
+#endif
+
+constexpr double MIN_DURATION = 0.0;
+constexpr double MAX_DURATION = 86400.0; // 24 hours
+constexpr double EPSILON = 1e-9;
+
+// MARK: - Input scans
+
+inline size_t findDurationOutOfRange(const double* durations, size_t count) {
+#if TENNIS_ANALYZER_HEADER_ONLY
+    return scan::findDurationOutOfRange(durations, count, MIN_DURATION, MAX_DURATION);
+#else
+    return ::tennis::findDurationOutOfRange(durations, count, MIN_DURATION, MAX_DURATION);
+#endif
+}
+
+template <typename Scale = FivePointScale>
+inline size_t findIntensityOutOfRange(const uint8_t* intensities, size_t count) {
+#if TENNIS_ANALYZER_HEADER_ONLY
+    return scan::findIntensityOutOfRange(intensities, count, Scale::MIN, Scale::MAX);
+#else
+    return ::tennis::findIntensityOutOfRange(intensities, count, Scale::MIN, Scale::MAX);
+#endif
+}
+
+/**
+ * @brief Exact integer sum of intensity levels
+ *
+ * Equal to summing the levels as doubles front to back, since every
+ * partial sum is an integer far below 2^53.
+ */
+inline uint64_t sumIntensities(const uint8_t* intensities, size_t count) {
+#if TENNIS_ANALYZER_HEADER_ONLY
+    return scan::sumIntensities(intensities, count);
+#else
+    return ::tennis::sumIntensities(intensities, count);
+#endif
+}
+
+// MARK: - Statistics
+
+inline double mean(const double* values, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    double sum = std::accumulate(values, values + count, 0.0);
+    return sum / static_cast<double>(count);
+}
+
+/**
+ * @brief Sample standard deviation (n - 1 denominator)
+ */
+inline double standardDeviation(const double* values, size_t count) {
+    if (count < 2) {
+        return 0.0;
+    }
+
+    double meanValue = mean(values, count);
+    double sumSquaredDiff = 0.0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double diff = values[i] - meanValue;
+        sumSquaredDiff += diff * diff;
+    }
+
+    double variance = sumSquaredDiff / static_cast<double>(count - 1);
+    return std::sqrt(variance);
+}
+
+inline double coefficientOfVariation(const double* values, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    double meanValue = mean(values, count);
+    if (std::abs(meanValue) < EPSILON) {
+        return 0.0;
+    }
+
+    double stdDev = standardDeviation(values, count);
+    return stdDev / meanValue;
+}
+
+/**
+ * @brief Coefficient of variation of intensity levels, without a widened copy
+ */
+inline double coefficientOfVariation(const uint8_t* values, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    // Same results as widening to doubles first: the integer sum is exact
+    double meanValue = static_cast<double>(sumIntensities(values, count)) / static_cast<double>(count);
+    if (std::abs(meanValue) < EPSILON) {
+        return 0.0;
+    }
+    if (count < 2) {
+        return 0.0;
+    }
+
+    double sumSquaredDiff = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double diff = static_cast<double>(values[i]) - meanValue;
+        sumSquaredDiff += diff * diff;
+    }
+
+    double variance = sumSquaredDiff / static_cast<double>(count - 1);
+    return std::sqrt(variance) / meanValue;
+}
+
+/**
+ * @brief Normalize intensity from [Scale::MIN, Scale::MAX] to [0.0, 1.0]
+ */
+template <typename Scale = FivePointScale>
+inline double normalizeIntensity(uint8_t intensity) {
+    return Scale::normalize(intensity);
+}
+
+// MARK: - Metrics
+
+inline double totalActiveTime(const double* durations, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    return std::accumulate(durations, durations + count, 0.0);
+}
+
+/**
+ * @param restDurations count rest durations, or nullptr to assume rest equals work
+ */
+inline double workRestRatio(const double* durations, const double* restDurations, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    double totalWork = totalActiveTime(durations, count);
+    double totalRest = restDurations ? std::accumulate(restDurations, restDurations + count, 0.0) : totalWork;
+
+    if (totalRest < EPSILON) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    return totalWork / totalRest;
+}
+
+/**
+ * @brief Consistency score from the coefficients of variation of durations
+ * and intensities
+ */
+inline double consistencyFromVariation(double durationCV, double intensityCV, const ScoringConfig& config) {
+    double durationConsistency = 1.0 / (1.0 + durationCV);
+    double intensityConsistency = 1.0 / (1.0 + intensityCV);
+
+    // Combined consistency score (weighted average)
+    // Defaults: duration consistency 60%, intensity consistency 40%
+    double consistency = config.durationConsistencyWeight * durationConsistency +
+                         config.intensityConsistencyWeight * intensityConsistency;
+
+    // Clamp to [0.0, 1.0]
+    return std::max(0.0, std::min(1.0, consistency));
+}
+
+/**
+ * @brief Density score from its inputs for a session of count sets
+ *
+ * @param avgIntensity Mean normalized intensity
+ * @param workVolume Sum of duration times normalized intensity
+ * @param avgDuration Mean set duration
+ */
+inline double densityFromComponents(double avgIntensity, double workVolume, double avgDuration, size_t count,
+                                    const ScoringConfig& config) {
+    // Normalize metrics
+    // Intensity component: 0.0-1.0 (already normalized)
+    // Volume component: normalize by max possible (assuming max intensity and reasonable duration)
+    const double maxDuration = config.volumeReferenceDuration; // Default: 1 hour per set (reasonable max)
+    double volumeComponent = std::min(1.0, workVolume / (maxDuration * count));
+
+    // Duration distribution component (penalize very short or very long sets)
+    double durationComponent = 1.0;
+    if (avgDuration < config.shortSetThreshold) {
+        // Very short sets reduce density
+        durationComponent = avgDuration / config.shortSetThreshold;
+    } else if (avgDuration > config.longSetThreshold) {
+        // Very long sets also reduce density (fatigue factor)
+        durationComponent = config.longSetThreshold / avgDuration;
+    }
+
+    // Combined density score
+    // Defaults: intensity 40%, volume 40%, duration 20%
+    double density = config.densityIntensityWeight * avgIntensity +
+                     config.densityVolumeWeight * volumeComponent +
+                     config.densityDurationWeight * durationComponent;
+
+    // Clamp to [0.0, 1.0]
+    return std::max(0.0, std::min(1.0, density));
+}
+
+/**
+ * @brief Mean normalized intensity from the exact sum of count levels
+ *
+ * Dividing the integer sum of (level - MIN) once is what summing each
+ * normalized level gives on the 1-5 scale, where every term is a multiple
+ * of 1/4 and the double sum is exact.
+ */
+template <typename Scale = FivePointScale>
+inline double averageNormalizedIntensity(uint64_t levelTotal, size_t count) {
+    const int64_t levelSum = static_cast<int64_t>(levelTotal) - static_cast<int64_t>(count) * Scale::MIN;
+    double avgIntensity = static_cast<double>(levelSum) / static_cast<double>(Scale::MAX - Scale::MIN);
+    return avgIntensity / static_cast<double>(count);
+}
+
+/**
+ * @brief Consistency score; separate lengths match the vector API's
+ * behaviour for mismatched inputs
+ */
+inline double consistencyScore(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount,
+    const ScoringConfig& config
+) {
+    if (durationCount < 2) {
+        // Single set is considered perfectly consistent
+        return 1.0;
+    }
+
+    return consistencyFromVariation(coefficientOfVariation(durations, durationCount),
+                                    coefficientOfVariation(intensities, intensityCount), config);
+}
+
+template <typename Scale = FivePointScale>
+inline double trainingDensityScore(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount,
+    const ScoringConfig& config
+) {
+    if (durationCount == 0) {
+        return 0.0;
+    }
+
+    double avgIntensity = averageNormalizedIntensity<Scale>(sumIntensities(intensities, intensityCount),
+                                                            intensityCount);
+
+    // Calculate total work volume (intensity-weighted time)
+    double totalWorkVolume = 0.0;
+    for (size_t i = 0; i < durationCount; ++i) {
+        totalWorkVolume += durations[i] * normalizeIntensity<Scale>(intensities[i]);
+    }
+
+    return densityFromComponents(avgIntensity, totalWorkVolume, mean(durations, durationCount), durationCount,
+                                 config);
+}
+
+// MARK: - Whole analysis
+
+/**
+ * @brief Sizes, then every duration, then every intensity; first failure wins
+ */
+template <typename Scale = FivePointScale>
+inline ValidationResult checkInputs(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount
+) {
+    ValidationResult validation;
+
+    if (durationCount != intensityCount) {
+        validation.status = ValidationStatus::SizeMismatch;
+        return validation;
+    }
+
+    size_t invalid = findDurationOutOfRange(durations, durationCount);
+    if (invalid < durationCount) {
+        validation.status = ValidationStatus::DurationOutOfRange;
+        validation.index = invalid;
+        return validation;
+    }
+
+    invalid = findIntensityOutOfRange<Scale>(intensities, intensityCount);
+    if (invalid < intensityCount) {
+        validation.status = ValidationStatus::IntensityOutOfRange;
+        validation.index = invalid;
+        return validation;
+    }
+
+    return validation;
+}
+
+/**
+ * @brief Append the error message for a failed validation to `out`
+ *
+ * The message is built in place, so a string reused across sessions
+ * stops allocating once it has held the longest message.
+ */
+template <typename Scale = FivePointScale, typename String>
+inline void appendValidationMessage(String& out, const ValidationResult& validation) {
+    // Longest message: an intensity error with a 20-digit index, about 80 bytes
+    char message[128];
+    char* end = message;
+    auto appendText = [&end](const char* text) {
+        while (*text) {
+            *end++ = *text++;
+        }
+    };
+    auto appendNumber = [&end, &message](size_t value) {
+        end = std::to_chars(end, message + sizeof(message), value).ptr;
+    };
+
+    switch (validation.status) {
+        case ValidationStatus::Ok:
+            return;
+        case ValidationStatus::SizeMismatch:
+            appendText("Durations and intensities vectors must have the same size");
+            break;
+        case ValidationStatus::DurationOutOfRange:
+            appendText("Duration at index ");
+            appendNumber(validation.index);
+            appendText(" is out of valid range [0, 86400] seconds");
+            break;
+        case ValidationStatus::IntensityOutOfRange:
+            appendText("Intensity at index ");
+            appendNumber(validation.index);
+            appendText(" is out of valid range [");
+            appendNumber(Scale::MIN);
+            appendText(", ");
+            appendNumber(Scale::MAX);
+            appendText("]");
+            break;
+        default:
+            appendText("Invalid input");
+            break;
+    }
+    out.append(message, static_cast<size_t>(end - message));
+}
+
+/**
+ * @brief Error message for a failed validation, empty for Ok
+ */
+template <typename Scale = FivePointScale>
+inline std::string validationMessage(const ValidationResult& validation) {
+    std::string message;
+    appendValidationMessage<Scale>(message, validation);
+    return message;
+}
+
+/**
+ * @brief averageIntensity and totalWorkVolume of a validated session
+ */
+inline void intensityMetrics(const double* durations, const uint8_t* intensities, size_t count,
+                             AnalysisResult& result) {
+    result.averageIntensity = static_cast<double>(sumIntensities(intensities, count)) / static_cast<double>(count);
+    result.totalWorkVolume = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        result.totalWorkVolume += durations[i] * static_cast<double>(intensities[i]);
+    }
+}
+
+/**
+ * @brief Every metric of a validated session in two fused passes
+ *
+ * The first pass accumulates all sums at once and the second the squared
+ * deviations. Each accumulation still runs front to back over the sets,
+ * so results are bit-identical to computing the metrics one by one.
+ */
+template <typename Scale = FivePointScale>
+inline void computeMetrics(const double* durations, const uint8_t* intensities, size_t count,
+                           const ScoringConfig& config, AnalysisResult& result) {
+    double durationSum = 0.0;
+    double normalizedVolume = 0.0;
+    double workVolume = 0.0;
+    uint64_t intensitySum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double duration = durations[i];
+        const uint8_t level = intensities[i];
+        durationSum += duration;
+        normalizedVolume += duration * Scale::normalize(level);
+        workVolume += duration * static_cast<double>(level);
+        intensitySum += level;
+    }
+    const double durationMean = durationSum / static_cast<double>(count);
+    const double intensityMean = static_cast<double>(intensitySum) / static_cast<double>(count);
+
+    double consistency = 1.0; // Single set is considered perfectly consistent
+    if (count >= 2) {
+        double durationSquaredDiff = 0.0;
+        double intensitySquaredDiff = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            const double durationDiff = durations[i] - durationMean;
+            const double intensityDiff = static_cast<double>(intensities[i]) - intensityMean;
+            durationSquaredDiff += durationDiff * durationDiff;
+            intensitySquaredDiff += intensityDiff * intensityDiff;
+        }
+        const double durationCV = std::abs(durationMean) < EPSILON
+            ? 0.0
+            : std::sqrt(durationSquaredDiff / static_cast<double>(count - 1)) / durationMean;
+        const double intensityCV = std::abs(intensityMean) < EPSILON
+            ? 0.0
+            : std::sqrt(intensitySquaredDiff / static_cast<double>(count - 1)) / intensityMean;
+        consistency = consistencyFromVariation(durationCV, intensityCV, config);
+    }
+
+    result.totalActiveTime = durationSum;
+    if (count == 0) {
+        result.workRestRatio = 0.0;
+    } else if (durationSum < EPSILON) {
+        result.workRestRatio = std::numeric_limits<double>::infinity();
+    } else {
+        result.workRestRatio = durationSum / durationSum; // Rest assumed equal to work
+    }
+    result.consistencyScore = consistency;
+    result.trainingDensityScore =
+        count == 0 ? 0.0
+                   : densityFromComponents(averageNormalizedIntensity<Scale>(intensitySum, count), normalizedVolume,
+                                           durationMean, count, config);
+    result.averageIntensity = intensityMean;
+    result.totalWorkVolume = workVolume;
+    result.totalSets = count;
+}
+
+/**
+ * @brief Validate and analyze a session, as TennisAnalyzer::tryAnalyze
+ *
+ * Uses the given configuration rather than the live global one and
+ * records no metrics or latency samples.
+ *
+ * @param result Filled in only when the returned status is Ok
+ */
+template <typename Scale = FivePointScale>
+inline ValidationResult tryAnalyze(
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    AnalysisResult& result,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    ValidationResult validation = checkInputs<Scale>(durations, count, intensities, count);
+    if (validation.ok()) {
+        computeMetrics<Scale>(durations, intensities, count, config, result);
+    }
+    return validation;
+}
+
+/**
+ * @brief tryAnalyze for a set count fixed at compile time, so every loop
+ * has a constant trip count the compiler can unroll
+ */
+template <typename Scale = FivePointScale, size_t N>
+inline ValidationResult tryAnalyze(
+    const std::array<double, N>& durations,
+    const std::array<uint8_t, N>& intensities,
+    AnalysisResult& result,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    return tryAnalyze<Scale>(durations.data(), intensities.data(), N, result, config);
+}
+
+/**
+ * @brief tryAnalyze over the sets of an InlineSession
+ */
+template <typename Scale = FivePointScale, size_t N>
+inline ValidationResult tryAnalyze(
+    const InlineSession<N>& session,
+    AnalysisResult& result,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    return tryAnalyze<Scale>(session.durations(), session.intensities(), session.size(), result, config);
+}
+
+} // inline namespace
+} // namespace analysis
+} // namespace tennis
+
+#endif // TENNIS_ANALYSIS_KERNELS_HPP
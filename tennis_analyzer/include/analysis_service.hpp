@@ -0,0 +1,207 @@
+//
+//  analysis_service.hpp
+//  Tennis Training Session Analyzer
+//
+//  Thread-safe service layer around TennisAnalyzer
+//
+
+#ifndef TENNIS_ANALYSIS_SERVICE_HPP
+#define TENNIS_ANALYSIS_SERVICE_HPP
+
+#include "tennis_export.h"
+#include "tennis_analyzer.hpp"
+#include "decaying_estimate.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tennis {
+
+/**
+ * @brief Scheduling class of a submitted request
+ */
+enum class RequestPriority : uint8_t {
+    Interactive, // User-facing analyze calls; kept within the latency target
+    Batch        // Background work such as history reprocessing; deferred or shed under load
+};
+
+/**
+ * @brief Thrown (through the returned future) when a request is shed
+ */
+class TENNIS_API ServiceOverloaded : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Admission control settings for AnalysisService
+ */
+struct AnalysisServiceConfig {
+    size_t workerThreads = 0;                            // 0 = std::thread::hardware_concurrency()
+    std::chrono::microseconds latencyTarget{20000};      // Interactive queueing + service target
+    size_t maxInteractiveQueue = 4096;                   // Interactive requests beyond this are rejected
+    size_t maxBatchQueue = 65536;                        // Batch requests beyond this are shed
+    std::chrono::milliseconds maxBatchDeferral{30000};   // Batch requests waiting longer are shed
+    size_t reservedInteractiveWorkers = 1;               // Workers never given to batch work
+};
+
+/**
+ * @brief Thread-safe analysis entry point shared by all request handlers
+ *
+ * Concurrent requests for identical inputs are coalesced (single-flight):
+ * the first caller computes the analysis and every caller that arrives
+ * while it is in flight waits for and shares that result, including any
+ * validation exception. Inputs are matched by hash and then compared
+ * element-wise, so hash collisions never return the wrong result.
+ *
+ * submit() additionally queues work on an internal worker pool with
+ * latency-aware admission control. The cost of each request is estimated
+ * from its set count using a learned ns-per-set rate. Interactive requests
+ * are always served first; batch requests only run while the projected
+ * interactive delay is below the latency target, never occupy the reserved
+ * workers, and are shed once their queue is full or they have been
+ * deferred for too long.
+ *
+ * Each service publishes its Stats in metricsRegistry(), labelled with a
+ * per-process `service` index.
+ */
+class TENNIS_API AnalysisService {
+public:
+    struct Stats {
+        uint64_t computations;        // Analyses actually executed
+        uint64_t coalesced;           // Requests answered by another caller's computation
+        uint64_t shed;                // Submitted requests rejected by admission control
+        uint64_t deferred;            // Batch dispatches postponed because of interactive load
+        size_t queuedInteractive;     // Interactive requests waiting for a worker
+        size_t queuedBatch;           // Batch requests waiting for a worker
+        double interactiveQueueDelayUs; // Smoothed queueing delay of interactive requests
+        double estimatedNsPerSet;       // Learned per-set analysis cost
+    };
+
+    explicit AnalysisService(AnalysisServiceConfig config = {});
+    ~AnalysisService();
+
+    AnalysisService(const AnalysisService&) = delete;
+    AnalysisService& operator=(const AnalysisService&) = delete;
+
+    /**
+     * @brief Analyze a session, sharing work with identical in-flight requests
+     *
+     * Runs on the calling thread and bypasses admission control.
+     *
+     * @param durations Vector of set durations in seconds
+     * @param intensities Vector of intensity levels (1-5)
+     * @return AnalysisResult containing all calculated metrics
+     * @throws std::invalid_argument if inputs are invalid
+     */
+    AnalysisResult analyze(
+        const std::vector<double>& durations,
+        const std::vector<uint8_t>& intensities
+    );
+
+    /**
+     * @brief Analyze count sets held in caller-owned arrays, sharing work
+     * with identical in-flight requests
+     *
+     * @throws std::invalid_argument if inputs are invalid
+     */
+    AnalysisResult analyze(const double* durations, const uint8_t* intensities, size_t count);
+
+    template <size_t N>
+    AnalysisResult analyze(const InlineSession<N>& session) {
+        return analyze(session.durations(), session.intensities(), session.size());
+    }
+
+    /**
+     * @brief Queue a session for analysis on the worker pool
+     *
+     * Worker threads are started on first use. The future carries
+     * std::invalid_argument for invalid inputs and ServiceOverloaded if the
+     * request is shed.
+     */
+    std::future<AnalysisResult> submit(
+        std::vector<double> durations,
+        std::vector<uint8_t> intensities,
+        RequestPriority priority = RequestPriority::Interactive
+    );
+
+    /**
+     * @brief Queue an InlineSession; its sets are copied into the request
+     */
+    template <size_t N>
+    std::future<AnalysisResult> submit(
+        const InlineSession<N>& session,
+        RequestPriority priority = RequestPriority::Interactive
+    ) {
+        return submit(std::vector<double>(session.durations(), session.durations() + session.size()),
+                      std::vector<uint8_t>(session.intensities(), session.intensities() + session.size()),
+                      priority);
+    }
+
+    Stats stats() const;
+
+    /**
+     * @brief 64-bit hash of a session's inputs (bitwise over both columns)
+     */
+    static uint64_t hashInputs(
+        const std::vector<double>& durations,
+        const std::vector<uint8_t>& intensities
+    );
+
+    /**
+     * @brief hashInputs of count sets; equals the vector overload on the same sets
+     */
+    static uint64_t hashInputs(const double* durations, const uint8_t* intensities, size_t count);
+
+private:
+    struct InFlight;
+    struct Task;
+    using Clock = std::chrono::steady_clock;
+
+    void startWorkers();
+    void workerLoop();
+    double estimateCostNs(size_t sets) const;
+    double projectedInteractiveDelayNs() const;
+    bool popTask(std::unique_lock<std::mutex>& lock, Task& task);
+    void registerMetrics();
+
+    // Single-flight table
+    std::mutex mutex_;
+    std::unordered_multimap<uint64_t, std::shared_ptr<InFlight>> inFlight_;
+    std::atomic<uint64_t> computations_{0};
+    std::atomic<uint64_t> coalesced_{0};
+
+    // Worker pool and admission control (guarded by queueMutex_)
+    AnalysisServiceConfig config_;
+    std::once_flag workersStarted_;
+    std::vector<std::thread> workers_;
+    size_t workerCount_ = 0;
+    mutable std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::deque<Task> interactiveQueue_;
+    std::deque<Task> batchQueue_;
+    double interactiveBacklogNs_ = 0.0;    // Estimated cost of queued interactive work
+    DecayingEstimate interactiveDelayNs_;  // Smoothed interactive queueing delay, decaying when idle
+    double nsPerSet_ = 20.0;               // EWMA of measured cost per set
+    size_t runningBatch_ = 0;
+    bool stopping_ = false;
+    uint64_t shed_ = 0;
+    uint64_t deferred_ = 0;
+
+    std::vector<MetricsRegistry::CallbackId> metricIds_;
+};
+
+} // namespace tennis
+
+#endif // TENNIS_ANALYSIS_SERVICE_HPP
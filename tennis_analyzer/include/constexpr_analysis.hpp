@@ -0,0 +1,346 @@
+//
+//  constexpr_analysis.hpp
+//  Tennis Training Session Analyzer
+//
+//  Analysis of fixed-size sessions in constant expressions, so training
+//  templates can be scored at compile time and embedded as tables.
+//  Results are bit-identical to TennisAnalyzer::analyze on the same sets.
+//
+
+#ifndef TENNIS_CONSTEXPR_ANALYSIS_HPP
+#define TENNIS_CONSTEXPR_ANALYSIS_HPP
+
+#include "analysis_kernels.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace tennis {
+namespace compile_time {
+
+namespace detail {
+
+struct UInt128 {
+    uint64_t high;
+    uint64_t low;
+};
+
+constexpr UInt128 multiply(uint64_t a, uint64_t b) {
+    const uint64_t aLow = a & 0xFFFFFFFFu;
+    const uint64_t aHigh = a >> 32;
+    const uint64_t bLow = b & 0xFFFFFFFFu;
+    const uint64_t bHigh = b >> 32;
+
+    const uint64_t lowLow = aLow * bLow;
+    const uint64_t lowHigh = aLow * bHigh;
+    const uint64_t highLow = aHigh * bLow;
+    const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+
+    return {aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32),
+            (middle << 32) | (lowLow & 0xFFFFFFFFu)};
+}
+
+constexpr bool less(UInt128 a, UInt128 b) {
+    return a.high < b.high || (a.high == b.high && a.low < b.low);
+}
+
+constexpr double abs(double value) {
+    return value < 0.0 ? -value : value;
+}
+
+} // namespace detail
+
+/**
+ * @brief Correctly rounded square root, equal to std::sqrt for every input
+ *
+ * Newton's iteration gets within a few ulps; the result is then corrected
+ * with exact integer arithmetic on the significand.
+ */
+constexpr double sqrt(double x) {
+    if (!(x > 0.0) || x == std::numeric_limits<double>::infinity()) {
+        // NaN, zeros and infinity map to themselves, negatives to NaN
+        return x < 0.0 ? std::numeric_limits<double>::quiet_NaN() : x;
+    }
+
+    // x = y * 2^exponent with y in [1, 4) and an even exponent. Scaling by
+    // two is exact, subnormals included.
+    int exponent = 0;
+    double y = x;
+    while (y >= 2.0) {
+        y *= 0.5;
+        ++exponent;
+    }
+    while (y < 1.0) {
+        y *= 2.0;
+        --exponent;
+    }
+    if (exponent % 2 != 0) {
+        y *= 2.0;
+        --exponent;
+    }
+
+    constexpr double SIGNIFICAND_SCALE = 4503599627370496.0; // 2^52
+    double estimate = 0.5 * (1.0 + y);
+    for (int i = 0; i < 6; ++i) {
+        estimate = 0.5 * (estimate + y / estimate);
+    }
+
+    // root / 2^52 rounds sqrt(y) to nearest when
+    //   (2 root - 1)^2 < 4 * y * 2^104 < (2 root + 1)^2
+    // Neither side can be equal: odd squares against an even target.
+    const uint64_t significand = static_cast<uint64_t>(y * SIGNIFICAND_SCALE);
+    const detail::UInt128 target{significand >> 10, significand << 54};
+    uint64_t root = static_cast<uint64_t>(estimate * SIGNIFICAND_SCALE);
+    while (!detail::less(target, detail::multiply(2 * root + 1, 2 * root + 1))) {
+        ++root;
+    }
+    while (!detail::less(detail::multiply(2 * root - 1, 2 * root - 1), target)) {
+        --root;
+    }
+
+    double result = static_cast<double>(root) / SIGNIFICAND_SCALE;
+    for (int e = exponent / 2; e > 0; --e) {
+        result *= 2.0;
+    }
+    for (int e = exponent / 2; e < 0; ++e) {
+        result *= 0.5;
+    }
+    return result;
+}
+
+// MARK: - Statistics
+
+template <size_t N>
+constexpr double sum(const std::array<double, N>& values) {
+    double total = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+template <size_t N>
+constexpr double mean(const std::array<double, N>& values) {
+    if (N == 0) {
+        return 0.0;
+    }
+    return sum(values) / static_cast<double>(N);
+}
+
+/**
+ * @brief Sample variance (n - 1 denominator)
+ */
+template <size_t N>
+constexpr double variance(const std::array<double, N>& values) {
+    if (N < 2) {
+        return 0.0;
+    }
+
+    const double meanValue = mean(values);
+    double sumSquaredDiff = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        const double diff = values[i] - meanValue;
+        sumSquaredDiff += diff * diff;
+    }
+    return sumSquaredDiff / static_cast<double>(N - 1);
+}
+
+template <size_t N>
+constexpr double standardDeviation(const std::array<double, N>& values) {
+    if (N < 2) {
+        return 0.0;
+    }
+    return compile_time::sqrt(variance(values));
+}
+
+template <size_t N>
+constexpr double coefficientOfVariation(const std::array<double, N>& values) {
+    if (N == 0) {
+        return 0.0;
+    }
+
+    const double meanValue = mean(values);
+    if (detail::abs(meanValue) < analysis::EPSILON) {
+        return 0.0;
+    }
+    return standardDeviation(values) / meanValue;
+}
+
+template <size_t N>
+constexpr double coefficientOfVariation(const std::array<uint8_t, N>& values) {
+    if (N == 0) {
+        return 0.0;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < N; ++i) {
+        total += values[i];
+    }
+    const double meanValue = static_cast<double>(total) / static_cast<double>(N);
+    if (detail::abs(meanValue) < analysis::EPSILON || N < 2) {
+        return 0.0;
+    }
+
+    double sumSquaredDiff = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        const double diff = static_cast<double>(values[i]) - meanValue;
+        sumSquaredDiff += diff * diff;
+    }
+    return compile_time::sqrt(sumSquaredDiff / static_cast<double>(N - 1)) / meanValue;
+}
+
+template <typename Scale = FivePointScale>
+constexpr double normalizeIntensity(uint8_t intensity) {
+    return Scale::normalize(intensity);
+}
+
+// MARK: - Metrics
+
+template <size_t N>
+constexpr double totalActiveTime(const std::array<double, N>& durations) {
+    return sum(durations);
+}
+
+template <size_t N>
+constexpr double workRestRatio(const std::array<double, N>& durations, const std::array<double, N>& restDurations) {
+    if (N == 0) {
+        return 0.0;
+    }
+
+    const double totalRest = sum(restDurations);
+    if (totalRest < analysis::EPSILON) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return sum(durations) / totalRest;
+}
+
+/**
+ * @brief Work/rest ratio with rest assumed equal to work
+ */
+template <size_t N>
+constexpr double workRestRatio(const std::array<double, N>& durations) {
+    return workRestRatio(durations, durations);
+}
+
+template <size_t N>
+constexpr double consistencyScore(
+    const std::array<double, N>& durations,
+    const std::array<uint8_t, N>& intensities,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    if (N < 2) {
+        return 1.0;
+    }
+
+    const double durationConsistency = 1.0 / (1.0 + coefficientOfVariation(durations));
+    const double intensityConsistency = 1.0 / (1.0 + coefficientOfVariation(intensities));
+    const double consistency = config.durationConsistencyWeight * durationConsistency +
+                               config.intensityConsistencyWeight * intensityConsistency;
+    return std::max(0.0, std::min(1.0, consistency));
+}
+
+template <typename Scale = FivePointScale, size_t N>
+constexpr double trainingDensityScore(
+    const std::array<double, N>& durations,
+    const std::array<uint8_t, N>& intensities,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    if (N == 0) {
+        return 0.0;
+    }
+
+    int64_t levelSum = 0;
+    double totalWorkVolume = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        levelSum += intensities[i] - Scale::MIN;
+        totalWorkVolume += durations[i] * normalizeIntensity<Scale>(intensities[i]);
+    }
+    double avgIntensity =
+        static_cast<double>(levelSum) / static_cast<double>(Scale::MAX - Scale::MIN);
+    avgIntensity /= static_cast<double>(N);
+
+    const double avgDuration = mean(durations);
+    const double volumeComponent = std::min(1.0, totalWorkVolume / (config.volumeReferenceDuration * N));
+
+    double durationComponent = 1.0;
+    if (avgDuration < config.shortSetThreshold) {
+        durationComponent = avgDuration / config.shortSetThreshold;
+    } else if (avgDuration > config.longSetThreshold) {
+        durationComponent = config.longSetThreshold / avgDuration;
+    }
+
+    const double density = config.densityIntensityWeight * avgIntensity +
+                           config.densityVolumeWeight * volumeComponent +
+                           config.densityDurationWeight * durationComponent;
+    return std::max(0.0, std::min(1.0, density));
+}
+
+// MARK: - Whole analysis
+
+template <typename Scale = FivePointScale, size_t N>
+constexpr ValidationResult checkInputs(const std::array<double, N>& durations,
+                                       const std::array<uint8_t, N>& intensities) {
+    ValidationResult validation;
+    for (size_t i = 0; i < N; ++i) {
+        if (durations[i] < analysis::MIN_DURATION || durations[i] > analysis::MAX_DURATION) {
+            validation.status = ValidationStatus::DurationOutOfRange;
+            validation.index = i;
+            return validation;
+        }
+    }
+    for (size_t i = 0; i < N; ++i) {
+        if (!Scale::contains(intensities[i])) {
+            validation.status = ValidationStatus::IntensityOutOfRange;
+            validation.index = i;
+            return validation;
+        }
+    }
+    return validation;
+}
+
+/**
+ * @brief Analyze a fixed-size session, usable in constant expressions
+ *
+ * Invalid sets throw std::invalid_argument, which makes a constant
+ * evaluation ill-formed, so a bad template fails to compile. An empty
+ * session is not a constant expression (its average intensity is 0/0).
+ *
+ * @tparam Scale Intensity scale, 1-5 by default
+ * @param config Scoring configuration; the defaults reproduce analyze()
+ *               with an unmodified global configuration
+ */
+template <typename Scale = FivePointScale, size_t N>
+constexpr AnalysisResult analyze(
+    const std::array<double, N>& durations,
+    const std::array<uint8_t, N>& intensities,
+    const ScoringConfig& config = ScoringConfig{}
+) {
+    const ValidationResult validation = checkInputs<Scale>(durations, intensities);
+    if (!validation.ok()) {
+        throw std::invalid_argument(analysis::validationMessage<Scale>(validation));
+    }
+
+    uint64_t intensitySum = 0;
+    double totalWorkVolume = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        intensitySum += intensities[i];
+        totalWorkVolume += durations[i] * static_cast<double>(intensities[i]);
+    }
+
+    AnalysisResult result{};
+    result.totalActiveTime = totalActiveTime(durations);
+    result.workRestRatio = workRestRatio(durations);
+    result.consistencyScore = consistencyScore(durations, intensities, config);
+    result.trainingDensityScore = trainingDensityScore<Scale>(durations, intensities, config);
+    result.averageIntensity = static_cast<double>(intensitySum) / static_cast<double>(N);
+    result.totalWorkVolume = totalWorkVolume;
+    result.totalSets = N;
+    return result;
+}
+
+} // namespace compile_time
+} // namespace tennis
+
+#endif // TENNIS_CONSTEXPR_ANALYSIS_HPP
@@ -0,0 +1,66 @@
+//
+//  decaying_estimate.hpp
+//  Tennis Training Session Analyzer
+//
+//  Smoothed load signal that forgets with elapsed time rather than with
+//  the number of times it is looked at
+//
+
+#ifndef TENNIS_DECAYING_ESTIMATE_HPP
+#define TENNIS_DECAYING_ESTIMATE_HPP
+
+#include <chrono>
+#include <cmath>
+
+namespace tennis {
+
+/**
+ * @brief Exponentially weighted average whose value decays towards zero
+ * over quiet periods
+ *
+ * Each sample moves the value `alpha` of the way towards it. Between
+ * samples, decay() scales it by exp(-elapsed / timeConstant) for the time
+ * since the last sample or decay. The factors multiply, so calling decay()
+ * once or a thousand times over the same interval leaves the same value:
+ * how often workers wake up cannot erase the signal. Not thread-safe; the
+ * owner guards it.
+ */
+class DecayingEstimate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    DecayingEstimate(double alpha, Clock::duration timeConstant)
+        : alpha_(alpha), timeConstantNs_(std::chrono::duration<double, std::nano>(timeConstant).count()) {}
+
+    /**
+     * @brief Blend in a sample taken at `now`
+     */
+    void addSample(double sample, Clock::time_point now) {
+        value_ += alpha_ * (sample - value_);
+        updated_ = now;
+    }
+
+    /**
+     * @brief Decay the value for the time between the last update and `now`
+     */
+    void decay(Clock::time_point now) {
+        if (now <= updated_) {
+            return;
+        }
+        const double elapsedNs = std::chrono::duration<double, std::nano>(now - updated_).count();
+        value_ *= std::exp(-elapsedNs / timeConstantNs_);
+        updated_ = now;
+    }
+
+    double value() const { return value_; }
+
+private:
+    double alpha_;
+    double timeConstantNs_;
+    double value_ = 0.0;
+    Clock::time_point updated_{};
+};
+
+} // namespace tennis
+
+#endif // TENNIS_DECAYING_ESTIMATE_HPP
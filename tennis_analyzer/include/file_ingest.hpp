@@ -0,0 +1,109 @@
+//
+//  file_ingest.hpp
+//  Tennis Training Session Analyzer
+//
+//  Bulk session file reader with an io_uring fast path (POSIX only)
+//
+
+#ifndef TENNIS_FILE_INGEST_HPP
+#define TENNIS_FILE_INGEST_HPP
+
+#include "tennis_export.h"
+#include "session_file.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tennis {
+
+/**
+ * @brief Reader settings
+ */
+struct FileIngestConfig {
+    size_t queueDepth = 32;          // Reads kept in flight
+    size_t bufferSize = 256 * 1024;  // Bytes per read buffer; larger files are read synchronously
+    bool preferIoUring = true;       // Set to false to force the pread path
+};
+
+/**
+ * @brief Outcome of one ingest() call
+ */
+struct FileIngestStats {
+    size_t filesRead = 0;
+    size_t failures = 0;
+    size_t bytesRead = 0;
+    bool usedIoUring = false;
+    bool usedRegisteredBuffers = false;
+};
+
+/**
+ * @brief Reads many session files with many reads in flight
+ *
+ * On Linux the reader sets up an io_uring instance with one page-aligned
+ * buffer per queue slot. The buffers are registered with the kernel so
+ * reads use IORING_OP_READ_FIXED. If registration is refused (e.g. by
+ * RLIMIT_MEMLOCK), plain vectored reads are used on the same ring. When
+ * io_uring is unavailable (older kernels, seccomp, other platforms),
+ * files are read one at a time with pread().
+ *
+ * Each completed file is decoded in place and handed to the session
+ * handler straight from the read buffer, so callers can feed it into
+ * TennisAnalyzer, a SessionBatch or AnalysisService::submit() without an
+ * extra copy. The view is only valid during the callback.
+ */
+class TENNIS_API FileIngestor {
+public:
+    using SessionHandler = std::function<void(const std::string& path, const SessionFileView& session)>;
+    using ErrorHandler = std::function<void(const std::string& path, const std::string& message)>;
+
+    explicit FileIngestor(FileIngestConfig config = {});
+    ~FileIngestor();
+
+    FileIngestor(const FileIngestor&) = delete;
+    FileIngestor& operator=(const FileIngestor&) = delete;
+
+    /**
+     * @brief Read and decode every file in `paths`
+     *
+     * Completion order follows I/O completion, not the order of `paths`.
+     * An exception from a handler stops the call: outstanding reads are
+     * waited for and their files closed before it propagates, so the
+     * ingestor can be used again.
+     *
+     * @param onSession Called once per successfully decoded file
+     * @param onError Called for files that cannot be opened, read or decoded
+     */
+    FileIngestStats ingest(
+        const std::vector<std::string>& paths,
+        const SessionHandler& onSession,
+        const ErrorHandler& onError = {}
+    );
+
+    /**
+     * @brief Whether ingest() will use io_uring
+     */
+    bool usingIoUring() const;
+
+private:
+    struct Ring;
+    struct AlignedBuffer;
+
+    static AlignedBuffer allocateBuffer(size_t size);
+    void ingestWithPread(const std::vector<std::string>& paths, const SessionHandler& onSession,
+                         const ErrorHandler& onError, FileIngestStats& stats);
+    void ingestWithIoUring(const std::vector<std::string>& paths, const SessionHandler& onSession,
+                           const ErrorHandler& onError, FileIngestStats& stats);
+    bool readWholeFile(int fd, size_t size, const std::string& path, const SessionHandler& onSession,
+                       const ErrorHandler& onError, FileIngestStats& stats);
+
+    FileIngestConfig config_;
+    std::unique_ptr<Ring> ring_;
+    std::vector<AlignedBuffer> buffers_;
+    std::vector<double> oversized_; // Scratch for files larger than bufferSize (double for alignment)
+};
+
+} // namespace tennis
+
+#endif // TENNIS_FILE_INGEST_HPP
@@ -0,0 +1,169 @@
+//
+//  inline_session.hpp
+//  Tennis Training Session Analyzer
+//
+//  Session value type that stores short sessions inline, so building and
+//  analyzing a typical session never touches the heap
+//
+
+#ifndef TENNIS_INLINE_SESSION_HPP
+#define TENNIS_INLINE_SESSION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tennis {
+
+/**
+ * @brief A session's durations and intensities, with room for N sets inline
+ *
+ * Up to N sets live in the object itself. Adding set N + 1 moves the
+ * session to heap storage, which is kept when the session is cleared, so
+ * a reused session reallocates only when it outgrows its largest size so
+ * far. Every TennisAnalyzer, analysis::, SessionBatch and AnalysisService
+ * entry point has an overload taking one.
+ *
+ * @tparam N Sets stored inline; the default covers most sessions
+ */
+template <size_t N = 32>
+class InlineSession {
+public:
+    static_assert(N > 0, "an inline session needs room for at least one set");
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    InlineSession() = default;
+
+    /**
+     * @brief Copy count sets out of caller-owned arrays
+     */
+    InlineSession(const double* durations, const uint8_t* intensities, size_t count) {
+        assign(durations, intensities, count);
+    }
+
+    InlineSession(const InlineSession& other) {
+        assign(other.durations(), other.intensities(), other.size_);
+    }
+
+    InlineSession(InlineSession&& other) noexcept
+        : heapDurations_(std::move(other.heapDurations_)),
+          heapIntensities_(std::move(other.heapIntensities_)),
+          size_(other.size_) {
+        if (size_ <= N) {
+            std::copy_n(other.inlineDurations_, size_, inlineDurations_);
+            std::copy_n(other.inlineIntensities_, size_, inlineIntensities_);
+        }
+        other.size_ = 0;
+    }
+
+    InlineSession& operator=(const InlineSession& other) {
+        if (this != &other) {
+            assign(other.durations(), other.intensities(), other.size_);
+        }
+        return *this;
+    }
+
+    InlineSession& operator=(InlineSession&& other) noexcept {
+        if (this != &other) {
+            heapDurations_ = std::move(other.heapDurations_);
+            heapIntensities_ = std::move(other.heapIntensities_);
+            size_ = other.size_;
+            if (size_ <= N) {
+                std::copy_n(other.inlineDurations_, size_, inlineDurations_);
+                std::copy_n(other.inlineIntensities_, size_, inlineIntensities_);
+            }
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append one set
+     */
+    void addSet(double duration, uint8_t intensity) {
+        if (size_ < N) {
+            inlineDurations_[size_] = duration;
+            inlineIntensities_[size_] = intensity;
+            ++size_;
+            return;
+        }
+        if (size_ == capacity()) {
+            reserve(2 * size_);
+        }
+        if (size_ == N) {
+            heapDurations_.assign(inlineDurations_, inlineDurations_ + N);
+            heapIntensities_.assign(inlineIntensities_, inlineIntensities_ + N);
+        }
+        // Both columns have room, so neither push can throw and leave them uneven
+        heapDurations_.push_back(duration);
+        heapIntensities_.push_back(intensity);
+        ++size_;
+    }
+
+    /**
+     * @brief Replace the session with count sets from caller-owned arrays
+     */
+    void assign(const double* durations, const uint8_t* intensities, size_t count) {
+        if (count <= N) {
+            heapDurations_.clear();
+            heapIntensities_.clear();
+            std::copy_n(durations, count, inlineDurations_);
+            std::copy_n(intensities, count, inlineIntensities_);
+        } else {
+            reserve(count);
+            heapDurations_.assign(durations, durations + count);
+            heapIntensities_.assign(intensities, intensities + count);
+        }
+        size_ = count;
+    }
+
+    /**
+     * @brief Make room for count sets; only allocates beyond N
+     */
+    void reserve(size_t count) {
+        if (count > N) {
+            heapDurations_.reserve(count);
+            heapIntensities_.reserve(count);
+        }
+    }
+
+    /**
+     * @brief Remove all sets, keeping any heap capacity
+     */
+    void clear() {
+        heapDurations_.clear();
+        heapIntensities_.clear();
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const {
+        return std::max(N, std::min(heapDurations_.capacity(), heapIntensities_.capacity()));
+    }
+
+    /**
+     * @brief True while the sets are stored in the object itself
+     */
+    bool isInline() const { return size_ <= N; }
+
+    const double* durations() const { return isInline() ? inlineDurations_ : heapDurations_.data(); }
+    const uint8_t* intensities() const { return isInline() ? inlineIntensities_ : heapIntensities_.data(); }
+    double* durations() { return isInline() ? inlineDurations_ : heapDurations_.data(); }
+    uint8_t* intensities() { return isInline() ? inlineIntensities_ : heapIntensities_.data(); }
+
+private:
+    // The sets are inline while size_ <= N and in the heap columns, which
+    // are otherwise empty, once it is larger
+    double inlineDurations_[N];
+    uint8_t inlineIntensities_[N];
+    std::vector<double> heapDurations_;
+    std::vector<uint8_t> heapIntensities_;
+    size_t size_ = 0;
+};
+
+} // namespace tennis
+
+#endif // TENNIS_INLINE_SESSION_HPP
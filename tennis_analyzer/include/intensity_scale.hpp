@@ -0,0 +1,65 @@
+//
+//  intensity_scale.hpp
+//  Tennis Training Session Analyzer
+//
+//  Compile-time intensity scales: the valid level range and a lookup table
+//  of normalized levels. Analysis kernels are templated on the scale, so
+//  each one gets its own specialized code instead of a runtime branch.
+//
+
+#ifndef TENNIS_INTENSITY_SCALE_HPP
+#define TENNIS_INTENSITY_SCALE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tennis {
+
+/**
+ * @brief Intensity levels Min..Max, stored one byte per set
+ *
+ * NORMALIZED maps every byte value to (level - Min) / (Max - Min), the
+ * exact double the division produces, out-of-range levels included so
+ * unvalidated inputs behave as the formula would.
+ */
+template <uint8_t Min, uint8_t Max>
+struct IntensityScale {
+    static_assert(Min < Max, "an intensity scale needs at least two levels");
+
+    static constexpr uint8_t MIN = Min;
+    static constexpr uint8_t MAX = Max;
+
+    static constexpr std::array<double, 256> makeNormalizationTable() {
+        std::array<double, 256> table{};
+        for (size_t level = 0; level < table.size(); ++level) {
+            table[level] = static_cast<double>(static_cast<int>(level) - Min) / static_cast<double>(Max - Min);
+        }
+        return table;
+    }
+
+    static constexpr std::array<double, 256> NORMALIZED = makeNormalizationTable();
+
+    static constexpr bool contains(uint8_t level) { return level >= Min && level <= Max; }
+
+    static constexpr double normalize(uint8_t level) { return NORMALIZED[level]; }
+};
+
+/**
+ * @brief The original 1-5 scale (see Intensity); used by TennisAnalyzer
+ */
+using FivePointScale = IntensityScale<1, 5>;
+
+/**
+ * @brief Rating of perceived exertion, 1-10
+ */
+using RpeScale = IntensityScale<1, 10>;
+
+/**
+ * @brief Percent of maximum heart rate, 0-100
+ */
+using PercentScale = IntensityScale<0, 100>;
+
+} // namespace tennis
+
+#endif // TENNIS_INTENSITY_SCALE_HPP
@@ -0,0 +1,105 @@
+//
+//  json_reader.hpp
+//  Tennis Training Session Analyzer
+//
+//  Minimal allocation-free pull parser for JSON request bodies
+//
+
+#ifndef TENNIS_JSON_READER_HPP
+#define TENNIS_JSON_READER_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace tennis {
+
+/**
+ * @brief Pull-style JSON reader over a caller-owned buffer
+ *
+ * Values are consumed in document order; the reader never builds a tree
+ * and never allocates. Any syntax error puts the reader into a failed
+ * state in which every call returns false.
+ *
+ * Typical object walk:
+ * @code
+ *   JsonReader r(body, size);
+ *   std::string_view key;
+ *   if (r.beginObject()) {
+ *       while (r.nextMember(key)) {
+ *           if (key == "durations") { ... } else { r.skipValue(); }
+ *       }
+ *   }
+ *   bool ok = r.finish();
+ * @endcode
+ */
+class TENNIS_API JsonReader {
+public:
+    JsonReader(const char* data, size_t size);
+
+    /**
+     * @brief Consume '{'
+     */
+    bool beginObject();
+
+    /**
+     * @brief Advance to the next member of the current object
+     *
+     * @param key Receives the member name (escape sequences are not decoded)
+     * @return true if positioned on a member value, false after the closing '}'
+     */
+    bool nextMember(std::string_view& key);
+
+    /**
+     * @brief Consume '['
+     */
+    bool beginArray();
+
+    /**
+     * @brief Advance to the next element of the current array
+     *
+     * @return true if positioned on an element, false after the closing ']'
+     */
+    bool nextElement();
+
+    bool readNumber(double& value);
+    bool readString(std::string_view& value);
+    bool readBool(bool& value);
+
+    /**
+     * @brief True if the next value is the literal null (does not consume it)
+     */
+    bool peekNull();
+
+    /**
+     * @brief Skip over the next value of any type
+     */
+    bool skipValue();
+
+    /**
+     * @brief Check that only whitespace remains and no error occurred
+     */
+    bool finish();
+
+    bool failed() const { return failed_; }
+
+private:
+    static constexpr int MAX_DEPTH = 32;
+
+    void skipWhitespace();
+    bool fail();
+    bool consume(char c);
+    bool consumeLiteral(const char* literal, size_t length);
+    bool advanceInContainer(char close);
+
+    const char* pos_;
+    const char* end_;
+    int depth_;
+    bool failed_;
+    bool first_[MAX_DEPTH]; // Whether the container at each depth has yielded a value yet
+};
+
+} // namespace tennis
+
+#endif // TENNIS_JSON_READER_HPP
@@ -0,0 +1,118 @@
+//
+//  kernel_dispatch.hpp
+//  Tennis Training Session Analyzer
+//
+//  ISA-specific variants of the input-scanning and result-packing kernels,
+//  selected once per process. The scans are used through analysis_kernels.hpp
+//  unless that is built header-only.
+//
+
+#ifndef TENNIS_KERNEL_DISPATCH_HPP
+#define TENNIS_KERNEL_DISPATCH_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tennis {
+
+struct AnalysisResult;
+struct PackedAnalysisResult;
+
+/**
+ * @brief One instruction-set variant of the kernels
+ *
+ * Every variant returns exactly what the scalar loops would: the scans
+ * only compare, the sums are integer and packing converts each field on
+ * its own, so wider vectors never change a result, only how fast it is
+ * produced.
+ */
+struct KernelTable {
+    const char* isa;
+
+    /**
+     * @brief Index of the first duration outside [min, max], or count if none
+     *
+     * NaN compares false against both bounds and is not reported, as in
+     * the scalar check.
+     */
+    size_t (*findDurationOutOfRange)(const double* durations, size_t count, double min, double max);
+
+    /**
+     * @brief Index of the first intensity outside [min, max], or count if none
+     */
+    size_t (*findIntensityOutOfRange)(const uint8_t* intensities, size_t count, uint8_t min, uint8_t max);
+
+    /**
+     * @brief Sum of count intensity levels
+     */
+    uint64_t (*sumIntensities)(const uint8_t* intensities, size_t count);
+
+    /**
+     * @brief packResult() over count results
+     */
+    void (*packResults)(const AnalysisResult* results, size_t count, PackedAnalysisResult* packed);
+
+    /**
+     * @brief unpackResult() over count results
+     */
+    void (*unpackResults)(const PackedAnalysisResult* packed, size_t count, AnalysisResult* results);
+};
+
+/**
+ * @brief The variant used by the analyzer
+ *
+ * Chosen on first use: the widest variant the CPU supports, unless the
+ * TENNIS_ANALYZER_ISA environment variable names another supported one
+ * (e.g. "generic" to compare against the baseline build).
+ */
+TENNIS_API const KernelTable& kernels();
+
+/**
+ * @brief Every variant the running CPU supports, baseline first
+ */
+TENNIS_API std::vector<const KernelTable*> supportedKernelTables();
+
+// Below this many sets the indirect call and vector setup cost more than
+// the scan itself, so the wrappers below loop inline instead
+constexpr size_t KERNEL_DISPATCH_MIN_COUNT = 32;
+
+inline size_t findDurationOutOfRange(const double* durations, size_t count, double min, double max) {
+    if (count >= KERNEL_DISPATCH_MIN_COUNT) {
+        return kernels().findDurationOutOfRange(durations, count, min, max);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (durations[i] < min || durations[i] > max) {
+            return i;
+        }
+    }
+    return count;
+}
+
+inline size_t findIntensityOutOfRange(const uint8_t* intensities, size_t count, uint8_t min, uint8_t max) {
+    if (count >= KERNEL_DISPATCH_MIN_COUNT) {
+        return kernels().findIntensityOutOfRange(intensities, count, min, max);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (intensities[i] < min || intensities[i] > max) {
+            return i;
+        }
+    }
+    return count;
+}
+
+inline uint64_t sumIntensities(const uint8_t* intensities, size_t count) {
+    if (count >= KERNEL_DISPATCH_MIN_COUNT) {
+        return kernels().sumIntensities(intensities, count);
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += intensities[i];
+    }
+    return total;
+}
+
+} // namespace tennis
+
+#endif // TENNIS_KERNEL_DISPATCH_HPP
@@ -0,0 +1,173 @@
+//
+//  latency_histogram.hpp
+//  Tennis Training Session Analyzer
+//
+//  Per-stage latency histograms, compiled in with
+//  TENNIS_ANALYZER_ENABLE_HISTOGRAMS=1
+//
+
+#ifndef TENNIS_LATENCY_HISTOGRAM_HPP
+#define TENNIS_LATENCY_HISTOGRAM_HPP
+
+#include "tennis_export.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef TENNIS_ANALYZER_ENABLE_HISTOGRAMS
+#define TENNIS_ANALYZER_ENABLE_HISTOGRAMS 0
+#endif
+
+namespace tennis {
+
+/**
+ * @brief Instrumented stages of the analysis pipeline
+ */
+enum class LatencyStage : uint8_t {
+    Validate,             // TennisAnalyzer::validateInputs
+    TotalActiveTime,      // calculateTotalActiveTime
+    WorkRestRatio,        // calculateWorkRestRatio
+    ConsistencyScore,     // calculateConsistencyScore
+    TrainingDensityScore, // calculateTrainingDensityScore
+    Analyze,              // TennisAnalyzer::analyze, end to end
+    AnalyzeBatch,         // analyzeBatch, whole batch
+    ServiceQueueWait,     // AnalysisService::submit until a worker picks the task up
+    ServiceExecute,       // AnalysisService worker running one task
+    ShmAnalyze            // ShmSessionChannel::analyzeNext, one session
+};
+
+constexpr size_t LATENCY_STAGE_COUNT = 10;
+
+constexpr bool LATENCY_HISTOGRAMS_ENABLED = TENNIS_ANALYZER_ENABLE_HISTOGRAMS != 0;
+
+/**
+ * @brief Stage name used in reports (e.g. "consistency_score")
+ */
+TENNIS_API const char* latencyStageName(LatencyStage stage);
+
+/**
+ * @brief Log-linear latency histogram in nanoseconds
+ *
+ * HDR-style bucketing: values below 32 ns are exact, and every power of two
+ * above that is split into 32 equal buckets, so any recorded value is known
+ * to within 1/32 (about 3%). Values up to 2^43 ns (about 2.4 hours) are
+ * tracked; larger values land in the last bucket. Histograms are plain
+ * values and merge by adding bucket counts.
+ */
+class TENNIS_API LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 42;
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    static size_t bucketIndex(uint64_t nanoseconds);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index); // Exclusive
+
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds, uint64_t count = 1);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+    uint64_t sum() const { return sum_; }
+
+    /**
+     * @brief Smallest recorded bucket bound covering `percentile` (0-100) of values
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+
+    uint64_t bucketCount(size_t index) const { return counts_[index]; }
+
+private:
+    friend struct ThreadLatencyRecorder;
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t sum_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+/**
+ * @brief Merged view of every thread's histograms at one point in time
+ */
+class TENNIS_API LatencySnapshot {
+public:
+    LatencySnapshot() : stages_(LATENCY_STAGE_COUNT) {}
+
+    const LatencyHistogram& operator[](LatencyStage stage) const {
+        return stages_[static_cast<size_t>(stage)];
+    }
+    LatencyHistogram& operator[](LatencyStage stage) {
+        return stages_[static_cast<size_t>(stage)];
+    }
+
+private:
+    std::vector<LatencyHistogram> stages_;
+};
+
+/**
+ * @brief Merge the histograms of all live and exited threads
+ *
+ * Recording threads are never blocked; counts being written during the
+ * snapshot may or may not be included. Empty when histograms are compiled out.
+ */
+TENNIS_API LatencySnapshot latencySnapshot();
+
+/**
+ * @brief Clear all histograms (increments racing with the reset may be lost)
+ */
+TENNIS_API void resetLatencyHistograms();
+
+#if TENNIS_ANALYZER_ENABLE_HISTOGRAMS
+
+/**
+ * @brief Add one sample to the calling thread's histogram for `stage`
+ *
+ * Each thread owns its histograms, so recording is a few uncontended
+ * relaxed atomic operations with no locking or cache-line sharing.
+ */
+TENNIS_API void recordLatency(LatencyStage stage, uint64_t nanoseconds);
+
+/**
+ * @brief Records the lifetime of the enclosing scope
+ */
+class TENNIS_API LatencyTimer {
+public:
+    explicit LatencyTimer(LatencyStage stage)
+        : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+
+    ~LatencyTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        recordLatency(stage_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+    LatencyStage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define TENNIS_LATENCY_SCOPE(stage) ::tennis::LatencyTimer tennisLatencyScope_(::tennis::LatencyStage::stage)
+
+#else
+
+inline void recordLatency(LatencyStage, uint64_t) {}
+
+#define TENNIS_LATENCY_SCOPE(stage) ((void)0)
+
+#endif // TENNIS_ANALYZER_ENABLE_HISTOGRAMS
+
+} // namespace tennis
+
+#endif // TENNIS_LATENCY_HISTOGRAM_HPP
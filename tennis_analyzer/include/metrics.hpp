@@ -0,0 +1,139 @@
+//
+//  metrics.hpp
+//  Tennis Training Session Analyzer
+//
+//  Production counters and gauges with Prometheus text exposition.
+//  Library counters are compiled in with TENNIS_ANALYZER_ENABLE_METRICS=1
+//
+
+#ifndef TENNIS_METRICS_HPP
+#define TENNIS_METRICS_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef TENNIS_ANALYZER_ENABLE_METRICS
+#define TENNIS_ANALYZER_ENABLE_METRICS 0
+#endif
+
+namespace tennis {
+
+constexpr bool METRICS_ENABLED = TENNIS_ANALYZER_ENABLE_METRICS != 0;
+
+/**
+ * @brief Counters maintained by the library itself
+ */
+enum class MetricCounter : uint8_t {
+    SessionsAnalyzed,              // Sessions that passed validation and were analyzed
+    SetsAnalyzed,                  // Sets in those sessions
+    BatchesAnalyzed,               // analyzeBatch calls
+    ValidationSizeMismatch,        // Rejected: durations and intensities differ in length
+    ValidationDurationOutOfRange,  // Rejected: a duration outside [0, 86400] seconds
+    ValidationIntensityOutOfRange  // Rejected: an intensity outside [1, 5]
+};
+
+constexpr size_t METRIC_COUNTER_COUNT = 6;
+
+/**
+ * @brief Total of a library counter over all live and exited threads
+ *
+ * Always 0 when metrics are compiled out.
+ */
+TENNIS_API uint64_t metricCounterValue(MetricCounter counter);
+
+/**
+ * @brief Zero all library counters
+ *
+ * Safe from any thread. An increment concurrent with the reset is either
+ * cleared by it or counted after it; later increments are never lost.
+ */
+TENNIS_API void resetMetricCounters();
+
+#if TENNIS_ANALYZER_ENABLE_METRICS
+
+/**
+ * @brief Add to the calling thread's copy of `counter`
+ *
+ * Each thread owns its counters, so this is an uncontended relaxed load
+ * and store with no locking or shared cache lines.
+ */
+TENNIS_API void incrementMetric(MetricCounter counter, uint64_t amount = 1);
+
+#else
+
+inline void incrementMetric(MetricCounter, uint64_t = 1) {}
+
+#endif // TENNIS_ANALYZER_ENABLE_METRICS
+
+enum class MetricType : uint8_t {
+    Counter,
+    Gauge
+};
+
+/**
+ * @brief Metrics sampled when the exposition is written
+ *
+ * Components register callbacks for values they already keep (queue
+ * depths, service counters) instead of updating a second copy on every
+ * request. The exposition also contains the library counters and, when
+ * histograms are compiled in, the per-stage latency histograms.
+ *
+ * Callbacks run with the registry locked, so removeCallback() returns only
+ * once no exposition is reading the removed callback.
+ */
+class TENNIS_API MetricsRegistry {
+public:
+    using CallbackId = uint64_t;
+
+    /**
+     * @brief Register a sampled metric
+     *
+     * @param name Metric name, e.g. "tennis_service_queue_depth"
+     * @param help One-line description for the HELP comment
+     * @param labels Label pairs without braces, e.g. `queue="batch"` (may be empty)
+     * @param sample Returns the current value
+     * @return Id to pass to removeCallback()
+     */
+    CallbackId addCallback(MetricType type, std::string name, std::string help, std::string labels,
+                           std::function<double()> sample);
+
+    void removeCallback(CallbackId id);
+
+    /**
+     * @brief Append every metric in Prometheus text format (version 0.0.4)
+     */
+    void writePrometheus(std::string& out) const;
+
+private:
+    struct Callback {
+        CallbackId id;
+        MetricType type;
+        std::string name;
+        std::string help;
+        std::string labels;
+        std::function<double()> sample;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Callback> callbacks_;
+    CallbackId nextId_ = 1;
+};
+
+/**
+ * @brief Process-wide registry served by the daemon's /metrics endpoint
+ */
+TENNIS_API MetricsRegistry& metricsRegistry();
+
+/**
+ * @brief Content-Type of the Prometheus text format
+ */
+constexpr const char* PROMETHEUS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+} // namespace tennis
+
+#endif // TENNIS_METRICS_HPP
@@ -0,0 +1,177 @@
+//
+//  packed_result.hpp
+//  Tennis Training Session Analyzer
+//
+//  Compact 20-byte storage format for analysis results
+//
+
+#ifndef TENNIS_PACKED_RESULT_HPP
+#define TENNIS_PACKED_RESULT_HPP
+
+#include "tennis_export.h"
+#include "tennis_analyzer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace tennis {
+
+/**
+ * @brief AnalysisResult in 20 bytes instead of 56, for keeping results resident
+ *
+ * Packing loses precision as follows (unpack(pack(r)) against r):
+ * - totalActiveTime, totalWorkVolume: float, relative error at most 2^-24
+ *   (a 24-hour total is kept to within 3 ms); below 2^-126 the error is
+ *   absolute, at most 2^-150
+ * - consistencyScore, trainingDensityScore: steps of 1/65535 over [0, 1],
+ *   error at most 7.7e-6. NaN packs as 0, which the analyzer never produces
+ * - averageIntensity: steps of 1/512 over [0, 127.996], error at most
+ *   0.001. NaN (an empty session) is kept
+ * - workRestRatio: IEEE half precision of the float value, relative error
+ *   at most 2^-11 (absolute, at most 2^-25, below 2^-14). 0, 1, infinity
+ *   are exact, NaN stays NaN; ratios of 65520 and up become infinity
+ * - totalSets: exact up to 2^32 - 1, then saturates
+ *
+ * Packing is deterministic: packResult() and every packResults() variant
+ * produce the same bytes.
+ */
+struct PackedAnalysisResult {
+    float totalActiveTime;
+    float totalWorkVolume;
+    uint32_t totalSets;
+    uint16_t consistencyScore;     // round(score * 65535)
+    uint16_t trainingDensityScore; // round(score * 65535)
+    uint16_t averageIntensity;     // round(average * 512), 0xFFFF for NaN
+    uint16_t workRestRatio;        // IEEE binary16 bits
+};
+
+static_assert(sizeof(PackedAnalysisResult) == 20, "PackedAnalysisResult must stay 20 bytes");
+
+namespace packing {
+
+constexpr double SCORE_STEPS = 65535.0;
+constexpr double INTENSITY_STEPS_PER_LEVEL = 512.0;
+constexpr uint16_t INTENSITY_NAN = 0xFFFF;
+constexpr double MAX_INTENSITY = (INTENSITY_NAN - 1) / INTENSITY_STEPS_PER_LEVEL;
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief [0, 1] score to 16-bit fixed point, rounding half up
+ */
+inline uint16_t encodeScore(double score) {
+    double clamped = score > 0.0 ? score : 0.0; // NaN fails the comparison
+    clamped = clamped < 1.0 ? clamped : 1.0;
+    return static_cast<uint16_t>(static_cast<int32_t>(clamped * SCORE_STEPS + 0.5));
+}
+
+inline double decodeScore(uint16_t score) {
+    return static_cast<double>(score) / SCORE_STEPS;
+}
+
+inline uint16_t encodeIntensity(double average) {
+    double clamped = average > 0.0 ? average : 0.0;
+    clamped = clamped < MAX_INTENSITY ? clamped : MAX_INTENSITY;
+    const uint16_t level = static_cast<uint16_t>(static_cast<int32_t>(clamped * INTENSITY_STEPS_PER_LEVEL + 0.5));
+    return average == average ? level : INTENSITY_NAN;
+}
+
+inline double decodeIntensity(uint16_t average) {
+    return average == INTENSITY_NAN ? std::numeric_limits<double>::quiet_NaN()
+                                    : static_cast<double>(average) / INTENSITY_STEPS_PER_LEVEL;
+}
+
+/**
+ * @brief Float to IEEE binary16, rounding to nearest even
+ */
+inline uint16_t floatToHalf(float value) {
+    const uint32_t bits = floatBits(value);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    // Normal halves: rebias the exponent (127 -> 15), then round off 13
+    // mantissa bits; a carry out of the mantissa bumps the exponent
+    const uint32_t normal = (magnitude + 0xC8000FFFu + ((magnitude >> 13) & 1u)) >> 13;
+    // Subnormal halves: adding 0.5 leaves the rounded half mantissa in the low bits
+    const uint32_t subnormal = floatBits(bitsToFloat(magnitude) + 0.5f) - 0x3F000000u;
+    // 65520 and up become infinity; NaN is quieted and keeps the top of its
+    // payload, as the F16C conversion does
+    const uint32_t overflow = magnitude > 0x7F800000u ? 0x7E00u | ((magnitude >> 13) & 0x3FFu) : 0x7C00u;
+
+    uint32_t half = magnitude < 0x38800000u ? subnormal : normal;
+    half = magnitude >= 0x47800000u ? overflow : half;
+    return static_cast<uint16_t>(half | sign);
+}
+
+inline float halfToFloat(uint16_t half) {
+    const uint32_t shifted = static_cast<uint32_t>(half & 0x7FFFu) << 13;
+    const uint32_t exponent = shifted & 0x0F800000u;
+
+    const uint32_t normal = shifted + 0x38000000u;
+    const uint32_t infinityOrNan = normal + 0x38000000u;
+    const uint32_t subnormal = floatBits(bitsToFloat(normal + 0x00800000u) - bitsToFloat(0x38800000u));
+
+    uint32_t bits = exponent == 0 ? subnormal : normal;
+    bits = exponent == 0x0F800000u ? infinityOrNan : bits;
+    return bitsToFloat(bits | (static_cast<uint32_t>(half & 0x8000u) << 16));
+}
+
+inline uint32_t encodeSetCount(size_t sets) {
+    return sets > std::numeric_limits<uint32_t>::max() ? std::numeric_limits<uint32_t>::max()
+                                                      : static_cast<uint32_t>(sets);
+}
+
+} // namespace packing
+
+inline PackedAnalysisResult packResult(const AnalysisResult& result) {
+    PackedAnalysisResult packed;
+    packed.totalActiveTime = static_cast<float>(result.totalActiveTime);
+    packed.totalWorkVolume = static_cast<float>(result.totalWorkVolume);
+    packed.totalSets = packing::encodeSetCount(result.totalSets);
+    packed.consistencyScore = packing::encodeScore(result.consistencyScore);
+    packed.trainingDensityScore = packing::encodeScore(result.trainingDensityScore);
+    packed.averageIntensity = packing::encodeIntensity(result.averageIntensity);
+    packed.workRestRatio = packing::floatToHalf(static_cast<float>(result.workRestRatio));
+    return packed;
+}
+
+inline AnalysisResult unpackResult(const PackedAnalysisResult& packed) {
+    AnalysisResult result;
+    result.totalActiveTime = packed.totalActiveTime;
+    result.workRestRatio = packing::halfToFloat(packed.workRestRatio);
+    result.consistencyScore = packing::decodeScore(packed.consistencyScore);
+    result.trainingDensityScore = packing::decodeScore(packed.trainingDensityScore);
+    result.averageIntensity = packing::decodeIntensity(packed.averageIntensity);
+    result.totalWorkVolume = packed.totalWorkVolume;
+    result.totalSets = packed.totalSets;
+    return result;
+}
+
+/**
+ * @brief Pack `count` results, compiled for the CPU (see kernels())
+ *
+ * Produces exactly the bytes packResult() would.
+ */
+TENNIS_API void packResults(const AnalysisResult* results, size_t count, PackedAnalysisResult* packed);
+
+/**
+ * @brief Unpack `count` results, compiled for the CPU
+ *
+ * Produces exactly the values unpackResult() would.
+ */
+TENNIS_API void unpackResults(const PackedAnalysisResult* packed, size_t count, AnalysisResult* results);
+
+} // namespace tennis
+
+#endif // TENNIS_PACKED_RESULT_HPP
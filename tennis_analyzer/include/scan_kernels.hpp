@@ -0,0 +1,82 @@
+//
+//  scan_kernels.hpp
+//  Tennis Training Session Analyzer
+//
+//  Portable input scans shared by every ISA variant in kernel_dispatch.cpp
+//  and by the header-only analysis kernels
+//
+
+#ifndef TENNIS_SCAN_KERNELS_HPP
+#define TENNIS_SCAN_KERNELS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace tennis {
+namespace scan {
+
+// Scans test a block branch-free, so the compiler can vectorize it, and
+// only search it element by element once something is out of range.
+// Blocks keep the early exit cheap for invalid sessions.
+constexpr size_t SCAN_BLOCK = 256;
+
+// Intensities are summed in 32-bit lanes per block; 255 * 2^16 fits easily
+constexpr size_t SUM_BLOCK = size_t(1) << 16;
+
+inline size_t findDurationOutOfRange(const double* durations, size_t count, double min, double max) {
+    for (size_t start = 0; start < count; start += SCAN_BLOCK) {
+        const size_t end = std::min(count, start + SCAN_BLOCK);
+        // The flag is a double so it shares the durations' lane width;
+        // integer flags keep baseline SSE2 builds from vectorizing
+        double outOfRange = 0.0;
+        for (size_t i = start; i < end; ++i) {
+            outOfRange = durations[i] < min ? 1.0 : outOfRange;
+            outOfRange = durations[i] > max ? 1.0 : outOfRange;
+        }
+        if (outOfRange != 0.0) {
+            for (size_t i = start; i < end; ++i) {
+                if (durations[i] < min || durations[i] > max) {
+                    return i;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+inline size_t findIntensityOutOfRange(const uint8_t* intensities, size_t count, uint8_t min, uint8_t max) {
+    for (size_t start = 0; start < count; start += SCAN_BLOCK) {
+        const size_t end = std::min(count, start + SCAN_BLOCK);
+        unsigned outOfRange = 0;
+        for (size_t i = start; i < end; ++i) {
+            outOfRange |= static_cast<unsigned>(intensities[i] < min) | static_cast<unsigned>(intensities[i] > max);
+        }
+        if (outOfRange) {
+            for (size_t i = start; i < end; ++i) {
+                if (intensities[i] < min || intensities[i] > max) {
+                    return i;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+inline uint64_t sumIntensities(const uint8_t* intensities, size_t count) {
+    uint64_t total = 0;
+    for (size_t start = 0; start < count; start += SUM_BLOCK) {
+        const size_t end = std::min(count, start + SUM_BLOCK);
+        uint32_t blockSum = 0;
+        for (size_t i = start; i < end; ++i) {
+            blockSum += intensities[i];
+        }
+        total += blockSum;
+    }
+    return total;
+}
+
+} // namespace scan
+} // namespace tennis
+
+#endif // TENNIS_SCAN_KERNELS_HPP
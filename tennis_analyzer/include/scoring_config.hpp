@@ -0,0 +1,132 @@
+//
+//  scoring_config.hpp
+//  Tennis Training Session Analyzer
+//
+//  Tunable scoring weights with read-copy-update publication
+//
+
+#ifndef TENNIS_SCORING_CONFIG_HPP
+#define TENNIS_SCORING_CONFIG_HPP
+
+#include "tennis_export.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace tennis {
+
+/**
+ * @brief Weights and thresholds used by the consistency and density scores
+ *
+ * Defaults reproduce the original fixed scoring.
+ */
+struct TENNIS_API ScoringConfig {
+    // Consistency score: weighted blend of duration and intensity consistency
+    double durationConsistencyWeight = 0.6;
+    double intensityConsistencyWeight = 0.4;
+
+    // Training density score: intensity, volume and duration components
+    double densityIntensityWeight = 0.4;
+    double densityVolumeWeight = 0.4;
+    double densityDurationWeight = 0.2;
+
+    double volumeReferenceDuration = 3600.0; // Per-set duration treated as full volume
+    double shortSetThreshold = 30.0;         // Average durations below this reduce density
+    double longSetThreshold = 1800.0;        // Average durations above this reduce density
+
+    /**
+     * @brief Shared immutable instance holding the default values
+     */
+    static const ScoringConfig& defaults();
+};
+
+/**
+ * @brief Read-copy-update holder for the live ScoringConfig
+ *
+ * Readers take a Snapshot, which pins the current configuration without
+ * locks: entering and leaving a read section is one atomic increment and
+ * decrement on a per-thread-striped counter. publish() swaps in a new
+ * configuration immediately, then waits for a grace period (every reader
+ * that could still see the old configuration has left) before freeing it.
+ * In-flight analyses therefore finish with the configuration they started
+ * with, and readers never wait on writers.
+ */
+class TENNIS_API ScoringConfigHolder {
+public:
+    /**
+     * @brief Pinned view of one configuration version
+     */
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        const ScoringConfig& operator*() const { return *config_; }
+        const ScoringConfig* operator->() const { return config_; }
+
+    private:
+        friend class ScoringConfigHolder;
+        Snapshot(std::atomic<int64_t>* counter, const ScoringConfig* config)
+            : counter_(counter), config_(config) {}
+
+        std::atomic<int64_t>* counter_;
+        const ScoringConfig* config_;
+    };
+
+    explicit ScoringConfigHolder(const ScoringConfig& initial = ScoringConfig::defaults());
+    ~ScoringConfigHolder();
+
+    ScoringConfigHolder(const ScoringConfigHolder&) = delete;
+    ScoringConfigHolder& operator=(const ScoringConfigHolder&) = delete;
+
+    /**
+     * @brief Pin the current configuration (wait-free)
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Replace the configuration
+     *
+     * Readers see the new values as soon as this call starts; it returns
+     * once the previous version has been reclaimed. Concurrent publishers
+     * are serialized. Must not be called while holding a Snapshot of this
+     * holder on the same thread.
+     */
+    void publish(const ScoringConfig& next);
+
+    /**
+     * @brief Number of configurations published so far
+     */
+    uint64_t version() const { return version_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t STRIPES = 16;
+
+    // Two reader counters per stripe, one per grace-period phase, padded
+    // so stripes used by different threads never share a cache line
+    struct alignas(64) Stripe {
+        std::atomic<int64_t> readers[2];
+    };
+
+    void waitForReaders(unsigned phase);
+
+    std::atomic<const ScoringConfig*> current_;
+    std::atomic<unsigned> phase_{0};
+    std::atomic<uint64_t> version_{0};
+    mutable Stripe stripes_[STRIPES];
+    std::mutex publishMutex_;
+};
+
+/**
+ * @brief Process-wide holder read by default-constructed TennisAnalyzers
+ */
+TENNIS_API ScoringConfigHolder& globalScoringConfig();
+
+} // namespace tennis
+
+#endif // TENNIS_SCORING_CONFIG_HPP
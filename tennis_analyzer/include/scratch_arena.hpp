@@ -0,0 +1,117 @@
+//
+//  scratch_arena.hpp
+//  Tennis Training Session Analyzer
+//
+//  Per-thread bump arenas for short-lived scratch data
+//
+
+#ifndef TENNIS_SCRATCH_ARENA_HPP
+#define TENNIS_SCRATCH_ARENA_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace tennis {
+
+/**
+ * @brief Bump allocator for scratch data that dies with a batch
+ *
+ * Allocation moves a pointer forward through a chain of blocks and
+ * deallocation does nothing. Memory comes back all at once by rewinding
+ * to a marker (see Scope) or with reset(). Blocks are kept across
+ * rewinds, so once an arena has grown to a batch's working set, later
+ * batches of that size never reach the upstream resource.
+ *
+ * An arena is a std::pmr::memory_resource, so std::pmr containers and
+ * pmr::SessionBatch can allocate from it. It is not thread-safe; each
+ * thread uses its own (see threadScratchArena()).
+ */
+class TENNIS_API ScratchArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * @brief Position in the arena that everything after it can be rewound to
+     */
+    struct Marker {
+        void* block = nullptr;
+        size_t offset = 0;
+        size_t used = 0;
+    };
+
+    /**
+     * @brief Rewinds the arena to where it was when the scope was entered
+     *
+     * Scopes nest. Nothing allocated inside a scope may be used after it ends.
+     */
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena) : arena_(arena), marker_(arena.mark()) {}
+        ~Scope() { arena_.rewind(marker_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& arena_;
+        Marker marker_;
+    };
+
+    /**
+     * @param blockSize Size of the first block; later blocks double
+     * @param upstream Resource the blocks come from
+     */
+    explicit ScratchArena(size_t blockSize = DEFAULT_BLOCK_SIZE,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    Marker mark() const { return {current_, offset_, used_}; }
+
+    /**
+     * @brief Release everything allocated since `marker` was taken
+     */
+    void rewind(const Marker& marker);
+
+    /**
+     * @brief Release everything; call at batch boundaries, outside any Scope
+     */
+    void reset() { rewind(Marker{}); }
+
+    size_t bytesUsed() const { return used_; }
+    size_t capacity() const { return capacity_; }
+    uint64_t upstreamAllocations() const { return upstreamAllocations_; }
+
+private:
+    struct Block;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream_;
+    Block* first_ = nullptr;
+    Block* current_ = nullptr;   // Block being bumped; null before the first allocation
+    size_t offset_ = 0;          // Bytes consumed in current_
+    size_t used_ = 0;            // Bytes handed out since the last reset, padding included
+    size_t capacity_ = 0;
+    size_t nextBlockSize_;
+    uint64_t upstreamAllocations_ = 0;
+};
+
+/**
+ * @brief The calling thread's scratch arena
+ *
+ * Library code only allocates from it inside a ScratchArena::Scope, so a
+ * worker loop may reset() it between batches, though not from inside a
+ * callback the library is running.
+ */
+TENNIS_API ScratchArena& threadScratchArena();
+
+} // namespace tennis
+
+#endif // TENNIS_SCRATCH_ARENA_HPP
@@ -0,0 +1,258 @@
+//
+//  session_batch.hpp
+//  Tennis Training Session Analyzer
+//
+//  Columnar container for analyzing many training sessions at once
+//
+
+#ifndef TENNIS_SESSION_BATCH_HPP
+#define TENNIS_SESSION_BATCH_HPP
+
+#include "tennis_export.h"
+#include "tennis_analyzer.hpp"
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace tennis {
+
+/**
+ * @brief Columnar (structure-of-arrays) batch of training sessions
+ *
+ * All sets of all sessions are stored back to back in two flat columns.
+ * Session i owns the sets in [offsets[i], offsets[i + 1]).
+ */
+class TENNIS_API SessionBatch {
+public:
+    SessionBatch() : offsets_{0} {}
+
+    /**
+     * @brief Append a session to the batch
+     *
+     * @param durations Set durations in seconds
+     * @param intensities Intensity levels (1-5)
+     * @param count Number of sets in the session
+     */
+    void addSession(const double* durations, const uint8_t* intensities, size_t count);
+
+    /**
+     * @brief Append a session stored in vectors
+     *
+     * @throws std::invalid_argument if the vectors have different sizes
+     */
+    void addSession(const std::vector<double>& durations, const std::vector<uint8_t>& intensities);
+
+    /**
+     * @brief Append a session stored in an InlineSession
+     */
+    template <size_t N>
+    void addSession(const InlineSession<N>& session) {
+        addSession(session.durations(), session.intensities(), session.size());
+    }
+
+    /**
+     * @brief Pre-allocate space for sessions and sets
+     */
+    void reserve(size_t sessions, size_t sets);
+
+    /**
+     * @brief Remove all sessions, keeping allocated capacity
+     */
+    void clear();
+
+    size_t sessionCount() const { return offsets_.size() - 1; }
+    size_t totalSetCount() const { return durations_.size(); }
+    size_t setCount(size_t session) const { return offsets_[session + 1] - offsets_[session]; }
+
+    const double* durations(size_t session) const { return durations_.data() + offsets_[session]; }
+    const uint8_t* intensities(size_t session) const { return intensities_.data() + offsets_[session]; }
+
+private:
+    std::vector<double> durations_;
+    std::vector<uint8_t> intensities_;
+    std::vector<size_t> offsets_;
+};
+
+/**
+ * @brief Per-session results of a batch analysis
+ *
+ * Invalid sessions do not abort the batch: their slot in `results` is
+ * zeroed and `errors` holds the validation message. Valid sessions have
+ * an empty error string.
+ */
+struct BatchResult {
+    std::vector<AnalysisResult> results;
+    std::vector<std::string> errors;
+    size_t failedSessions = 0;
+
+    bool ok(size_t session) const { return errors[session].empty(); }
+};
+
+/**
+ * @brief Analyze every session of a batch
+ *
+ * @param batch Sessions to analyze
+ * @param out Result storage; resized to batch.sessionCount()
+ */
+TENNIS_API void analyzeBatch(const SessionBatch& batch, BatchResult& out);
+
+/**
+ * @brief Analyze sessions [first, last) of a batch
+ *
+ * `out` must already be sized for the whole batch (see prepareBatchResult);
+ * only the slots in the range are written and `out.failedSessions` is left
+ * alone. Threads may analyze disjoint ranges into the same `out` at once.
+ *
+ * @return Number of invalid sessions in the range
+ */
+TENNIS_API size_t analyzeBatchRange(const SessionBatch& batch, size_t first, size_t last, BatchResult& out);
+
+/**
+ * @brief Size `out` for `batch` and reset its failure count
+ */
+TENNIS_API void prepareBatchResult(const SessionBatch& batch, BatchResult& out);
+
+/**
+ * @brief Convenience overload returning a new BatchResult
+ */
+TENNIS_API BatchResult analyzeBatch(const SessionBatch& batch);
+
+// MARK: - Memory resource variants
+
+namespace pmr {
+
+/**
+ * @brief SessionBatch whose columns allocate from a std::pmr::memory_resource
+ *
+ * Backing each request with a std::pmr::monotonic_buffer_resource keeps
+ * batch building off the global allocator and releases the whole request
+ * at once. The batch is allocator-aware, so std::pmr containers of batches
+ * hand it their resource.
+ */
+class TENNIS_API SessionBatch {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    SessionBatch() : SessionBatch(allocator_type{}) {}
+
+    explicit SessionBatch(const allocator_type& allocator)
+        : durations_(allocator), intensities_(allocator), offsets_(1, 0, allocator) {}
+
+    SessionBatch(const SessionBatch& other) = default;
+    SessionBatch(SessionBatch&& other) = default;
+
+    SessionBatch(const SessionBatch& other, const allocator_type& allocator)
+        : durations_(other.durations_, allocator),
+          intensities_(other.intensities_, allocator),
+          offsets_(other.offsets_, allocator) {}
+
+    SessionBatch& operator=(const SessionBatch& other) = default;
+    SessionBatch& operator=(SessionBatch&& other) = default;
+
+    /**
+     * @brief Append a session to the batch
+     *
+     * @param durations Set durations in seconds
+     * @param intensities Intensity levels (1-5)
+     * @param count Number of sets in the session
+     */
+    void addSession(const double* durations, const uint8_t* intensities, size_t count);
+
+    /**
+     * @brief Append a session stored in vectors
+     *
+     * @throws std::invalid_argument if the vectors have different sizes
+     */
+    void addSession(const std::vector<double>& durations, const std::vector<uint8_t>& intensities);
+
+    /**
+     * @brief Append a session stored in an InlineSession
+     */
+    template <size_t N>
+    void addSession(const InlineSession<N>& session) {
+        addSession(session.durations(), session.intensities(), session.size());
+    }
+
+    /**
+     * @brief Pre-allocate space for sessions and sets
+     */
+    void reserve(size_t sessions, size_t sets);
+
+    /**
+     * @brief Remove all sessions, keeping allocated capacity
+     */
+    void clear();
+
+    allocator_type get_allocator() const { return durations_.get_allocator(); }
+    std::pmr::memory_resource* resource() const { return durations_.get_allocator().resource(); }
+
+    size_t sessionCount() const { return offsets_.size() - 1; }
+    size_t totalSetCount() const { return durations_.size(); }
+    size_t setCount(size_t session) const { return offsets_[session + 1] - offsets_[session]; }
+
+    const double* durations(size_t session) const { return durations_.data() + offsets_[session]; }
+    const uint8_t* intensities(size_t session) const { return intensities_.data() + offsets_[session]; }
+
+private:
+    std::pmr::vector<double> durations_;
+    std::pmr::vector<uint8_t> intensities_;
+    std::pmr::vector<size_t> offsets_;
+};
+
+/**
+ * @brief BatchResult whose results and error strings allocate from a
+ * std::pmr::memory_resource
+ */
+struct BatchResult {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::vector<AnalysisResult> results;
+    std::pmr::vector<std::pmr::string> errors;
+    size_t failedSessions = 0;
+
+    BatchResult() = default;
+    BatchResult(const BatchResult& other) = default;
+    BatchResult(BatchResult&& other) = default;
+
+    explicit BatchResult(const allocator_type& allocator) : results(allocator), errors(allocator) {}
+
+    BatchResult(const BatchResult& other, const allocator_type& allocator)
+        : results(other.results, allocator), errors(other.errors, allocator), failedSessions(other.failedSessions) {}
+
+    BatchResult& operator=(const BatchResult& other) = default;
+    BatchResult& operator=(BatchResult&& other) = default;
+
+    allocator_type get_allocator() const { return results.get_allocator(); }
+
+    bool ok(size_t session) const { return errors[session].empty(); }
+};
+
+} // namespace pmr
+
+/**
+ * @brief Analyze every session of a memory-resource batch
+ *
+ * Results and error strings are allocated from `out`'s resource.
+ */
+TENNIS_API void analyzeBatch(const pmr::SessionBatch& batch, pmr::BatchResult& out);
+
+/**
+ * @brief Analyze sessions [first, last) of a memory-resource batch
+ *
+ * Same contract as the SessionBatch overload.
+ */
+TENNIS_API size_t analyzeBatchRange(const pmr::SessionBatch& batch, size_t first, size_t last,
+                                    pmr::BatchResult& out);
+
+TENNIS_API void prepareBatchResult(const pmr::SessionBatch& batch, pmr::BatchResult& out);
+
+/**
+ * @brief Convenience overload allocating the results from the batch's resource
+ */
+TENNIS_API pmr::BatchResult analyzeBatch(const pmr::SessionBatch& batch);
+
+} // namespace tennis
+
+#endif // TENNIS_SESSION_BATCH_HPP
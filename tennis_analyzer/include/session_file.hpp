@@ -0,0 +1,90 @@
+//
+//  session_file.hpp
+//  Tennis Training Session Analyzer
+//
+//  Binary on-disk format for a single training session
+//
+
+#ifndef TENNIS_SESSION_FILE_HPP
+#define TENNIS_SESSION_FILE_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tennis {
+
+/**
+ * @brief Fixed header of a session file
+ *
+ * Layout (little-endian, no padding between sections):
+ *   SessionFileHeader (24 bytes)
+ *   double  durations[setCount]
+ *   uint8_t intensities[setCount]
+ *
+ * Durations start 8-byte aligned so a file read into an aligned buffer can
+ * be analyzed in place.
+ */
+struct SessionFileHeader {
+    char magic[4];      // "TPSF"
+    uint32_t version;   // SESSION_FILE_VERSION
+    uint64_t sessionId;
+    uint32_t setCount;
+    uint32_t reserved;
+};
+
+constexpr uint32_t SESSION_FILE_VERSION = 1;
+
+/**
+ * @brief Decoded session pointing into the buffer it was read from
+ */
+struct SessionFileView {
+    uint64_t sessionId;
+    const double* durations;
+    const uint8_t* intensities;
+    size_t setCount;
+};
+
+/**
+ * @brief Total encoded size of a session with `setCount` sets
+ */
+TENNIS_API size_t sessionFileSize(size_t setCount);
+
+/**
+ * @brief Serialize a session into `out` (replacing its contents)
+ */
+TENNIS_API void encodeSessionFile(
+    uint64_t sessionId,
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    std::vector<char>& out
+);
+
+/**
+ * @brief Write a session file
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+TENNIS_API void writeSessionFile(
+    const std::string& path,
+    uint64_t sessionId,
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+);
+
+/**
+ * @brief Decode a session file held in memory without copying
+ *
+ * @param data File contents (must be 8-byte aligned)
+ * @param size Number of bytes in `data`
+ * @param view Receives pointers into `data`
+ * @return nullptr on success, otherwise a static error message
+ */
+TENNIS_API const char* decodeSessionFile(const void* data, size_t size, SessionFileView& view);
+
+} // namespace tennis
+
+#endif // TENNIS_SESSION_FILE_HPP
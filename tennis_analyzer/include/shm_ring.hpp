@@ -0,0 +1,221 @@
+//
+//  shm_ring.hpp
+//  Tennis Training Session Analyzer
+//
+//  Shared-memory ring buffers for handing sessions and results between
+//  processes (POSIX only)
+//
+
+#ifndef TENNIS_SHM_RING_HPP
+#define TENNIS_SHM_RING_HPP
+
+#include "tennis_export.h"
+#include "tennis_analyzer.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tennis {
+
+/**
+ * @brief Bounded ring of fixed-size slots living in POSIX shared memory
+ *
+ * Slots are claimed with per-slot sequence numbers (Vyukov's bounded
+ * queue), so producers and consumers never take a lock. A ring created in
+ * SingleProducer mode skips the compare-and-swap on the producer side.
+ * Records are written and read in place: beginWrite()/commitWrite() and
+ * beginRead()/commitRead() hand out pointers straight into the mapping, so
+ * a cross-process handoff costs one write of the payload plus a few atomic
+ * operations. Blocking waits park on a futex in the shared header on Linux
+ * (short sleeps elsewhere), and wake-ups are only issued when a peer is
+ * actually waiting.
+ */
+class TENNIS_API ShmRing {
+public:
+    enum class Mode : uint32_t {
+        SingleProducer, // SPSC: exactly one producer process/thread
+        MultiProducer   // MPSC: any number of producers
+    };
+
+    struct WriteTicket {
+        void* data = nullptr;   // Payload area of the claimed slot
+        size_t capacity = 0;    // Usable bytes at `data`
+        uint64_t position = 0;
+    };
+
+    struct ReadTicket {
+        const void* data = nullptr;
+        size_t length = 0;      // Bytes committed by the producer
+        uint64_t position = 0;
+    };
+
+    /**
+     * @brief Create (or replace) a named ring and map it
+     *
+     * The creating side owns the name and unlinks it on destruction.
+     *
+     * @param name POSIX shared memory name, e.g. "/tennis-ingest"
+     * @param slotCount Number of slots (rounded up to a power of two)
+     * @param slotSize Maximum payload bytes per record
+     * @throws std::runtime_error if the segment cannot be created
+     */
+    static ShmRing create(const std::string& name, size_t slotCount, size_t slotSize, Mode mode);
+
+    /**
+     * @brief Map an existing ring created by another process
+     *
+     * The geometry in the shared header is validated once and copied; the
+     * ring never re-reads it, so a peer cannot change the bounds later.
+     *
+     * @throws std::runtime_error if the segment is missing or incompatible
+     */
+    static ShmRing open(const std::string& name);
+
+    ShmRing(ShmRing&& other) noexcept;
+    ShmRing& operator=(ShmRing&& other) noexcept;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * @brief Claim a free slot without blocking
+     *
+     * @return false if the ring is full
+     */
+    bool beginWrite(WriteTicket& ticket);
+
+    /**
+     * @brief Publish a claimed slot holding `length` payload bytes
+     */
+    void commitWrite(const WriteTicket& ticket, size_t length);
+
+    /**
+     * @brief Claim the oldest published slot without blocking
+     *
+     * @return false if the ring is empty
+     */
+    bool beginRead(ReadTicket& ticket);
+
+    /**
+     * @brief Release a slot after its payload has been consumed
+     */
+    void commitRead(const ReadTicket& ticket);
+
+    /**
+     * @brief Block until a slot can be written or the timeout expires
+     */
+    bool waitWritable(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Block until a record is available or the timeout expires
+     */
+    bool waitReadable(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Copying convenience wrapper around beginWrite()/commitWrite()
+     */
+    bool tryPush(const void* data, size_t length);
+
+    size_t slotSize() const;
+    size_t slotCount() const;
+
+private:
+    struct Header;
+
+    ShmRing(const std::string& name, void* mapping, size_t mappingSize, bool owner);
+    unsigned char* slot(uint64_t position) const;
+    void release();
+
+    std::string name_;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    bool owner_ = false;
+    Header* header_ = nullptr;
+
+    // Private copies of the geometry, validated when the ring was mapped
+    Mode mode_ = Mode::SingleProducer;
+    uint64_t slotCount_ = 0;
+    size_t slotSize_ = 0;
+    size_t slotStride_ = 0;
+};
+
+/**
+ * @brief Columnar session record carried from ingest to analysis
+ *
+ * Followed in the slot by `setCount` doubles (durations) and then
+ * `setCount` bytes (intensities).
+ */
+struct ShmSessionRecord {
+    uint64_t sessionId;
+    uint32_t setCount;
+    uint32_t reserved;
+};
+
+/**
+ * @brief Result record carried from analysis back to ingest
+ */
+struct ShmResultRecord {
+    uint64_t sessionId;
+    uint32_t status;     // 0 = analyzed, 1 = rejected by validation, 2 = malformed record
+    uint32_t reserved;
+    AnalysisResult result;
+};
+
+/**
+ * @brief Bidirectional session/result transport built from two rings
+ *
+ * The ingest process sends columnar session records on "<name>-sessions"
+ * and reads ShmResultRecord entries from "<name>-results". The analysis
+ * process does the reverse. Session records are written directly into the
+ * ring slots, so no intermediate serialization buffer is involved.
+ *
+ * A channel connects exactly one ingest process to one analysis process:
+ * results are not tagged with their sender, and the results ring has a
+ * single consumer.
+ */
+class TENNIS_API ShmSessionChannel {
+public:
+    /**
+     * @brief Create both rings (analysis side or whichever starts first)
+     *
+     * @param maxSetsPerSession Largest session a single record can carry
+     */
+    static ShmSessionChannel create(const std::string& name, size_t slotCount, size_t maxSetsPerSession);
+    static ShmSessionChannel open(const std::string& name);
+
+    /**
+     * @brief Write a session straight into a free slot
+     *
+     * @return false if the ring stays full for `timeout` or the session
+     *         does not fit in a slot
+     */
+    bool sendSession(uint64_t sessionId, const double* durations, const uint8_t* intensities,
+                     size_t count, std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Analyze the next session and post its result
+     *
+     * A record whose set count does not fit in the bytes committed for it
+     * is not analyzed; its result has status 2.
+     *
+     * @return false if no session arrived within `timeout`, or if the
+     *         results ring stayed full for `timeout` (the result is dropped)
+     */
+    bool analyzeNext(TennisAnalyzer& analyzer, std::chrono::nanoseconds timeout);
+
+    bool receiveResult(ShmResultRecord& record, std::chrono::nanoseconds timeout);
+
+    size_t maxSetsPerSession() const;
+
+private:
+    ShmSessionChannel(ShmRing sessions, ShmRing results);
+
+    ShmRing sessions_;
+    ShmRing results_;
+};
+
+} // namespace tennis
+
+#endif // TENNIS_SHM_RING_HPP
@@ -9,14 +9,22 @@
 #ifndef TENNIS_ANALYZER_HPP
 #define TENNIS_ANALYZER_HPP
 
+#include "tennis_export.h"
+#include "scoring_config.hpp"
+#include "inline_session.hpp"
 #include <vector>
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 
 namespace tennis {
 
 /**
  * @brief Intensity level for training sets (1-5 scale)
+ *
+ * TennisAnalyzer analyzes on this scale (FivePointScale). Other scales are
+ * available through the templated kernels in analysis_kernels.hpp.
  */
 enum class Intensity : uint8_t {
     VeryLow = 1,
@@ -41,6 +49,26 @@ struct AnalysisResult {
     size_t totalSets;             // Total number of sets
 };
 
+/**
+ * @brief Reason a session failed input validation
+ */
+enum class ValidationStatus : uint8_t {
+    Ok,
+    SizeMismatch,        // Durations and intensities differ in length
+    DurationOutOfRange,  // A duration is outside [0, 86400] seconds
+    IntensityOutOfRange  // An intensity is outside [1, 5]
+};
+
+/**
+ * @brief Outcome of TennisAnalyzer::checkInputs
+ */
+struct ValidationResult {
+    ValidationStatus status = ValidationStatus::Ok;
+    size_t index = 0; // First offending set for range errors
+    
+    constexpr bool ok() const { return status == ValidationStatus::Ok; }
+};
+
 /**
  * @brief Tennis Training Session Analyzer
  * 
@@ -48,13 +76,22 @@ struct AnalysisResult {
  * Provides metrics including total active time, work/rest ratio, consistency,
  * and training density.
  */
-class TennisAnalyzer {
+class TENNIS_API TennisAnalyzer {
 public:
     /**
      * @brief Default constructor
+     *
+     * Scores with the live configuration in globalScoringConfig().
      */
     TennisAnalyzer() = default;
     
+    /**
+     * @brief Construct an analyzer that scores with a specific configuration holder
+     *
+     * @param config Holder that must outlive the analyzer
+     */
+    explicit TennisAnalyzer(const ScoringConfigHolder& config) : config_(&config) {}
+    
     /**
      * @brief Destructor
      */
@@ -67,6 +104,9 @@ public:
     /**
      * @brief Analyze a training session
      * 
+     * Takes one snapshot of the scoring configuration, so a configuration
+     * published mid-analysis never mixes old and new weights.
+     * 
      * @param durations Vector of set durations in seconds
      * @param intensities Vector of intensity levels (1-5)
      * @return AnalysisResult containing all calculated metrics
@@ -77,6 +117,63 @@ public:
         const std::vector<uint8_t>& intensities
     );
     
+    /**
+     * @brief Analyze a training session without throwing
+     *
+     * Same metrics as analyze(); invalid input is reported through the
+     * return value instead of an exception, so rejecting a session does
+     * not allocate.
+     *
+     * @param result Filled in only when the returned status is Ok
+     */
+    ValidationResult tryAnalyze(
+        const std::vector<double>& durations,
+        const std::vector<uint8_t>& intensities,
+        AnalysisResult& result
+    );
+    
+    /**
+     * @brief Analyze a session held in caller-owned arrays without throwing
+     *
+     * Same as the vector overload, for data that already lives in a
+     * columnar batch, shared memory or a foreign buffer; nothing is copied.
+     *
+     * @param durations count set durations in seconds
+     * @param intensities count intensity levels (1-5)
+     * @param result Filled in only when the returned status is Ok
+     */
+    ValidationResult tryAnalyze(
+        const double* durations,
+        const uint8_t* intensities,
+        size_t count,
+        AnalysisResult& result
+    );
+    
+    /**
+     * @brief Analyze a session held in an InlineSession
+     *
+     * Sessions of up to N sets are built and analyzed without allocating.
+     *
+     * @throws std::invalid_argument if inputs are invalid
+     */
+    template <size_t N>
+    AnalysisResult analyze(const InlineSession<N>& session) {
+        AnalysisResult result;
+        ValidationResult validation = tryAnalyze(session, result);
+        if (!validation.ok()) {
+            throw std::invalid_argument(validationMessage(validation));
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Analyze a session held in an InlineSession without throwing
+     */
+    template <size_t N>
+    ValidationResult tryAnalyze(const InlineSession<N>& session, AnalysisResult& result) {
+        return tryAnalyze(session.durations(), session.intensities(), session.size(), result);
+    }
+    
     /**
      * @brief Calculate total active time
      * 
@@ -85,6 +182,11 @@ public:
      */
     static double calculateTotalActiveTime(const std::vector<double>& durations);
     
+    /**
+     * @brief Calculate total active time of count durations
+     */
+    static double calculateTotalActiveTime(const double* durations, size_t count);
+    
     /**
      * @brief Calculate work/rest ratio
      * 
@@ -100,6 +202,17 @@ public:
         const std::vector<double>& restDurations = {}
     );
     
+    /**
+     * @brief Calculate work/rest ratio of count sets
+     *
+     * @param restDurations count rest durations, or nullptr to assume rest equals work
+     */
+    static double calculateWorkRestRatio(
+        const double* durations,
+        const double* restDurations,
+        size_t count
+    );
+    
     /**
      * @brief Calculate consistency score
      * 
@@ -109,11 +222,23 @@ public:
      * 
      * @param durations Vector of set durations in seconds
      * @param intensities Vector of intensity levels (1-5)
+     * @param config Scoring weights (defaults to the original fixed weights)
      * @return Consistency score (0.0 = inconsistent, 1.0 = perfectly consistent)
      */
     static double calculateConsistencyScore(
         const std::vector<double>& durations,
-        const std::vector<uint8_t>& intensities
+        const std::vector<uint8_t>& intensities,
+        const ScoringConfig& config = ScoringConfig::defaults()
+    );
+    
+    /**
+     * @brief Calculate consistency score of count sets
+     */
+    static double calculateConsistencyScore(
+        const double* durations,
+        const uint8_t* intensities,
+        size_t count,
+        const ScoringConfig& config = ScoringConfig::defaults()
     );
     
     /**
@@ -126,14 +251,25 @@ public:
      * 
      * @param durations Vector of set durations in seconds
      * @param intensities Vector of intensity levels (1-5)
+     * @param config Scoring weights and thresholds (defaults to the original values)
      * @return Training density score (0.0 = low density, 1.0 = high density)
      */
     static double calculateTrainingDensityScore(
         const std::vector<double>& durations,
-        const std::vector<uint8_t>& intensities
+        const std::vector<uint8_t>& intensities,
+        const ScoringConfig& config = ScoringConfig::defaults()
     );
-
-private:
+    
+    /**
+     * @brief Calculate training density score of count sets
+     */
+    static double calculateTrainingDensityScore(
+        const double* durations,
+        const uint8_t* intensities,
+        size_t count,
+        const ScoringConfig& config = ScoringConfig::defaults()
+    );
+    
     /**
      * @brief Validate input vectors
      * 
@@ -147,24 +283,101 @@ private:
     );
     
     /**
-     * @brief Calculate mean of a vector
+     * @brief Validate input vectors without throwing or allocating
+     * 
+     * Checks sizes, then every duration, then every intensity, and reports
+     * the first failure.
      */
-    static double mean(const std::vector<double>& values);
+    static ValidationResult checkInputs(
+        const std::vector<double>& durations,
+        const std::vector<uint8_t>& intensities
+    ) noexcept;
     
     /**
-     * @brief Calculate standard deviation of a vector
+     * @brief Validate count durations and intensities without throwing or allocating
      */
-    static double standardDeviation(const std::vector<double>& values);
+    static ValidationResult checkInputs(
+        const double* durations,
+        const uint8_t* intensities,
+        size_t count
+    ) noexcept;
     
     /**
-     * @brief Calculate coefficient of variation
+     * @brief The calculations and validation over an InlineSession
      */
-    static double coefficientOfVariation(const std::vector<double>& values);
+    template <size_t N>
+    static double calculateTotalActiveTime(const InlineSession<N>& session) {
+        return calculateTotalActiveTime(session.durations(), session.size());
+    }
+    
+    template <size_t N>
+    static double calculateWorkRestRatio(const InlineSession<N>& session) {
+        return calculateWorkRestRatio(session.durations(), nullptr, session.size());
+    }
+    
+    template <size_t N>
+    static double calculateConsistencyScore(
+        const InlineSession<N>& session,
+        const ScoringConfig& config = ScoringConfig::defaults()
+    ) {
+        return calculateConsistencyScore(session.durations(), session.intensities(), session.size(), config);
+    }
+    
+    template <size_t N>
+    static double calculateTrainingDensityScore(
+        const InlineSession<N>& session,
+        const ScoringConfig& config = ScoringConfig::defaults()
+    ) {
+        return calculateTrainingDensityScore(session.durations(), session.intensities(), session.size(), config);
+    }
+    
+    template <size_t N>
+    static ValidationResult checkInputs(const InlineSession<N>& session) noexcept {
+        return checkInputs(session.durations(), session.intensities(), session.size());
+    }
     
     /**
-     * @brief Normalize intensity to 0.0-1.0 range
+     * @brief Human-readable message for a failed validation
+     *
+     * Matches the std::invalid_argument message thrown by validateInputs.
      */
-    static double normalizeIntensity(uint8_t intensity);
+    static std::string validationMessage(const ValidationResult& validation);
+
+private:
+    // The public overloads forward here. Separate lengths keep the vector
+    // overloads' behaviour for mismatched inputs.
+    ValidationResult tryAnalyze(
+        const double* durations,
+        size_t durationCount,
+        const uint8_t* intensities,
+        size_t intensityCount,
+        AnalysisResult& result
+    );
+    
+    static ValidationResult checkInputs(
+        const double* durations,
+        size_t durationCount,
+        const uint8_t* intensities,
+        size_t intensityCount
+    ) noexcept;
+    
+    static double consistencyScore(
+        const double* durations,
+        size_t durationCount,
+        const uint8_t* intensities,
+        size_t intensityCount,
+        const ScoringConfig& config
+    );
+    
+    static double trainingDensityScore(
+        const double* durations,
+        size_t durationCount,
+        const uint8_t* intensities,
+        size_t intensityCount,
+        const ScoringConfig& config
+    );
+    
+    const ScoringConfigHolder* config_ = nullptr; // nullptr = globalScoringConfig()
 };
 
 } // namespace tennis
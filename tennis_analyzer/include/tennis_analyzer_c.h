@@ -0,0 +1,146 @@
+/*
+ *  tennis_analyzer_c.h
+ *  Tennis Training Session Analyzer
+ *
+ *  Stable C interface for foreign-function callers (Swift, Python, Go, ...).
+ *  Inputs are read in place from caller-owned arrays and results are
+ *  written to caller-provided structs or columns; no call throws.
+ */
+
+#ifndef TENNIS_ANALYZER_C_H
+#define TENNIS_ANALYZER_C_H
+
+#include "tennis_export.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bumped only on incompatible changes. Structs below are frozen for a given
+ * version; new fields arrive in new structs and functions.
+ */
+#define TENNIS_C_ABI_VERSION 1
+
+/* Fixed-width so status columns have the same layout in every language */
+typedef int32_t tennis_status;
+
+enum {
+    TENNIS_OK = 0,
+    TENNIS_ERROR_DURATION_OUT_OF_RANGE = 1,  /* A duration is outside [0, 86400] seconds */
+    TENNIS_ERROR_INTENSITY_OUT_OF_RANGE = 2, /* An intensity is outside [1, 5] */
+    TENNIS_ERROR_INVALID_ARGUMENT = 3,       /* NULL pointer where data is required, bad offsets */
+    TENNIS_ERROR_OUT_OF_MEMORY = 4,
+    TENNIS_ERROR_INTERNAL = 5
+};
+
+/* Opaque analyzer. Stateless between calls, so one handle may be shared by
+ * any number of threads. */
+typedef struct tennis_analyzer tennis_analyzer;
+
+/* Metrics for one session; same meaning as tennis::AnalysisResult */
+typedef struct tennis_analysis_result {
+    double total_active_time;
+    double work_rest_ratio;
+    double consistency_score;
+    double training_density_score;
+    double average_intensity;
+    double total_work_volume;
+    uint64_t total_sets;
+} tennis_analysis_result;
+
+/*
+ * Columnar output for batches: each non-NULL pointer receives session_count
+ * values. Leave a column NULL to skip it.
+ */
+typedef struct tennis_result_columns {
+    double* total_active_time;
+    double* work_rest_ratio;
+    double* consistency_score;
+    double* training_density_score;
+    double* average_intensity;
+    double* total_work_volume;
+    uint64_t* total_sets;
+    tennis_status* status;
+    uint64_t* error_index; /* First offending set of a rejected session, 0 otherwise */
+} tennis_result_columns;
+
+/* TENNIS_C_ABI_VERSION the library was built with */
+TENNIS_API uint32_t tennis_abi_version(void);
+
+/* Static description of a status code; never NULL */
+TENNIS_API const char* tennis_status_message(tennis_status status);
+
+/* Returns NULL if the handle cannot be allocated */
+TENNIS_API tennis_analyzer* tennis_analyzer_create(void);
+
+/* Accepts NULL */
+TENNIS_API void tennis_analyzer_destroy(tennis_analyzer* analyzer);
+
+/*
+ * Analyze one session of count sets.
+ *
+ * durations and intensities may be NULL only when count is 0. result is
+ * written only on TENNIS_OK; error_index (optional) receives the first
+ * offending set when a range check fails.
+ */
+TENNIS_API tennis_status tennis_analyze(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    tennis_analysis_result* result,
+    size_t* error_index
+);
+
+/*
+ * Analyze session_count sessions stored back to back, as in a SessionBatch:
+ * session i is sets [offsets[i], offsets[i + 1]) of durations and
+ * intensities, so offsets holds session_count + 1 non-decreasing entries.
+ *
+ * results receives session_count results; entries for rejected sessions are
+ * zeroed. statuses (optional) receives each session's status and
+ * failed_sessions (optional) the number rejected. Per-session rejections
+ * still return TENNIS_OK; other codes mean nothing was analyzed.
+ */
+TENNIS_API tennis_status tennis_analyze_batch(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    const size_t* offsets,
+    size_t session_count,
+    tennis_analysis_result* results,
+    tennis_status* statuses,
+    size_t* failed_sessions
+);
+
+/* tennis_analyze_batch writing into columns instead of result structs */
+TENNIS_API tennis_status tennis_analyze_batch_columns(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    const size_t* offsets,
+    size_t session_count,
+    const tennis_result_columns* columns,
+    size_t* failed_sessions
+);
+
+/*
+ * Individual metrics with the default scoring configuration, unvalidated
+ * like their C++ counterparts. They return NaN when a required pointer is
+ * NULL with a non-zero count. rest_durations may be NULL to assume rest
+ * equals work.
+ */
+TENNIS_API double tennis_total_active_time(const double* durations, size_t count);
+TENNIS_API double tennis_work_rest_ratio(const double* durations, const double* rest_durations, size_t count);
+TENNIS_API double tennis_consistency_score(const double* durations, const uint8_t* intensities, size_t count);
+TENNIS_API double tennis_training_density_score(const double* durations, const uint8_t* intensities, size_t count);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TENNIS_ANALYZER_C_H */
@@ -0,0 +1,26 @@
+/*
+ *  tennis_export.h
+ *  Tennis Training Session Analyzer
+ *
+ *  Symbol visibility for the shared library. The library is compiled with
+ *  hidden visibility; TENNIS_API marks the public C and C++ surface.
+ */
+
+#ifndef TENNIS_EXPORT_H
+#define TENNIS_EXPORT_H
+
+#if defined(_WIN32)
+#  if !defined(TENNIS_ANALYZER_SHARED)
+#    define TENNIS_API
+#  elif defined(TENNIS_ANALYZER_BUILDING)
+#    define TENNIS_API __declspec(dllexport)
+#  else
+#    define TENNIS_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define TENNIS_API __attribute__((visibility("default")))
+#else
+#  define TENNIS_API
+#endif
+
+#endif /* TENNIS_EXPORT_H */
@@ -0,0 +1,135 @@
+//
+//  trace.hpp
+//  Tennis Training Session Analyzer
+//
+//  Timeline tracing in Chrome trace format, compiled in with
+//  TENNIS_ANALYZER_ENABLE_TRACING=1
+//
+
+#ifndef TENNIS_TRACE_HPP
+#define TENNIS_TRACE_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifndef TENNIS_ANALYZER_ENABLE_TRACING
+#define TENNIS_ANALYZER_ENABLE_TRACING 0
+#endif
+
+namespace tennis {
+
+constexpr bool TRACING_ENABLED = TENNIS_ANALYZER_ENABLE_TRACING != 0;
+
+constexpr uint64_t TRACE_NO_SESSION = UINT64_MAX;
+
+/**
+ * @brief Begin recording trace events
+ *
+ * Discards events from any previous trace. Each thread records into its
+ * own fixed-capacity buffer; once it is full, that thread's further events
+ * are counted as dropped rather than overwriting earlier ones. No-op when
+ * tracing is compiled out.
+ *
+ * @param eventsPerThread Buffer capacity per thread
+ */
+TENNIS_API void traceStart(size_t eventsPerThread = 1 << 16);
+
+/**
+ * @brief Stop recording; buffered events stay available for writing
+ */
+TENNIS_API void traceStop();
+
+/**
+ * @brief Whether events are currently being recorded
+ */
+TENNIS_API bool tracingActive();
+
+/**
+ * @brief Name the calling thread in the trace (e.g. "analysis-worker-0")
+ */
+TENNIS_API void setTraceThreadName(const std::string& name);
+
+/**
+ * @brief Write the current trace as Chrome trace JSON
+ *
+ * The output loads in chrome://tracing and ui.perfetto.dev. Call after
+ * traceStop() (or once traced threads are idle) for a complete trace;
+ * while threads are still recording it contains what has been published.
+ *
+ * @return Number of events written
+ */
+TENNIS_API size_t writeChromeTrace(std::ostream& out);
+
+/**
+ * @brief Write the trace to a file
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+TENNIS_API size_t writeChromeTraceFile(const std::string& path);
+
+/**
+ * @brief Events lost to full buffers in the current trace
+ */
+TENNIS_API uint64_t traceDroppedEvents();
+
+#if TENNIS_ANALYZER_ENABLE_TRACING
+
+/**
+ * @brief Nanoseconds on the trace clock (steady_clock)
+ */
+TENNIS_API uint64_t traceNow();
+
+/**
+ * @brief Append a complete event to the calling thread's buffer
+ *
+ * `name` and `argName` must point to strings that outlive the trace
+ * (normally literals). Wait-free: one buffer slot write and a release store.
+ */
+void recordTraceEvent(const char* name, uint64_t startNs, uint64_t endNs,
+                      uint64_t sessionId = TRACE_NO_SESSION, uint32_t setCount = 0,
+                      const char* argName = nullptr, uint64_t argValue = 0);
+
+/**
+ * @brief Records the enclosing scope as one trace event
+ */
+class TENNIS_API TraceScope {
+public:
+    explicit TraceScope(const char* name, uint64_t sessionId = TRACE_NO_SESSION, uint32_t setCount = 0)
+        : name_(name), sessionId_(sessionId), setCount_(setCount),
+          start_(tracingActive() ? traceNow() : 0) {}
+
+    ~TraceScope() {
+        if (start_ != 0) {
+            recordTraceEvent(name_, start_, traceNow(), sessionId_, setCount_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t sessionId_;
+    uint32_t setCount_;
+    uint64_t start_;
+};
+
+#define TENNIS_TRACE_SCOPE(...) ::tennis::TraceScope tennisTraceScope_(__VA_ARGS__)
+
+#else
+
+inline uint64_t traceNow() { return 0; }
+
+inline void recordTraceEvent(const char*, uint64_t, uint64_t, uint64_t = TRACE_NO_SESSION,
+                             uint32_t = 0, const char* = nullptr, uint64_t = 0) {}
+
+#define TENNIS_TRACE_SCOPE(...) ((void)0)
+
+#endif // TENNIS_ANALYZER_ENABLE_TRACING
+
+} // namespace tennis
+
+#endif // TENNIS_TRACE_HPP
@@ -0,0 +1,179 @@
+//
+//  workload_generator.hpp
+//  Tennis Training Session Analyzer
+//
+//  Seeded synthetic training sessions for benchmarks and load tests
+//
+
+#ifndef TENNIS_WORKLOAD_GENERATOR_HPP
+#define TENNIS_WORKLOAD_GENERATOR_HPP
+
+#include "tennis_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tennis {
+
+class SessionBatch;
+
+/**
+ * @brief Kind of training set, mirroring the app's SetType
+ */
+enum class SetType : uint8_t {
+    Rally,
+    Serve,
+    Drill
+};
+
+constexpr size_t SET_TYPE_COUNT = 3;
+
+/**
+ * @brief Pseudo-random generator with a fixed, documented algorithm
+ *
+ * xoshiro256** seeded through SplitMix64. Standard library engines and
+ * distributions are not used because their output differs between
+ * implementations.
+ */
+class TENNIS_API WorkloadRandom {
+public:
+    explicit WorkloadRandom(uint64_t seed);
+
+    uint64_t next();
+
+    /**
+     * @brief Uniform double in [0, 1) with 53 random bits
+     */
+    double uniform();
+
+    /**
+     * @brief Uniform integer in [low, high]
+     */
+    uint64_t uniformInt(uint64_t low, uint64_t high);
+
+    /**
+     * @brief Triangular distribution over [low, high] peaking at `mode`
+     */
+    double triangular(double low, double mode, double high);
+
+private:
+    uint64_t state_[4];
+};
+
+/**
+ * @brief Duration and intensity distribution of one set type
+ *
+ * Durations follow a triangular distribution; intensities are drawn from
+ * the relative weights of levels 1-5.
+ */
+struct SetTypeProfile {
+    double minDuration;         // Seconds
+    double typicalDuration;     // Most likely duration (seconds)
+    double maxDuration;         // Seconds
+    double intensityWeights[5]; // Relative weight of intensity 1..5
+};
+
+/**
+ * @brief Shape of the generated sessions
+ *
+ * Defaults model a club player's practice: mostly rallies, some drills,
+ * a few serve blocks, one to two minute rests.
+ */
+struct WorkloadConfig {
+    uint64_t seed = 1;
+
+    size_t minSets = 8;  // Sets per session, drawn uniformly
+    size_t maxSets = 40;
+
+    double typeMix[SET_TYPE_COUNT] = {0.55, 0.15, 0.30}; // Relative weight of Rally, Serve, Drill
+    SetTypeProfile profiles[SET_TYPE_COUNT] = {
+        {20.0, 90.0, 600.0, {0.05, 0.15, 0.35, 0.30, 0.15}},    // Rally
+        {60.0, 300.0, 1200.0, {0.10, 0.30, 0.40, 0.15, 0.05}},  // Serve
+        {120.0, 480.0, 1800.0, {0.02, 0.08, 0.25, 0.35, 0.30}}, // Drill
+    };
+
+    double minRest = 10.0;  // Rest gap between consecutive sets (seconds)
+    double typicalRest = 60.0;
+    double maxRest = 300.0;
+
+    double overlapRate = 0.0; // Probability a set starts before the previous one ended
+    double invalidRate = 0.0; // Probability a set record is corrupted (out-of-range value)
+};
+
+/**
+ * @brief One generated session
+ *
+ * durations/intensities are the analyzer inputs. startTimes and
+ * restDurations describe the timeline: restDurations[i] is the gap between
+ * the end of set i and the start of set i + 1, negative when they overlap.
+ */
+struct GeneratedSession {
+    uint64_t sessionId = 0;
+    std::vector<SetType> types;
+    std::vector<double> durations;
+    std::vector<uint8_t> intensities;
+    std::vector<double> startTimes;    // Seconds from session start
+    std::vector<double> restDurations; // One fewer than sets
+    size_t invalidRecords = 0;         // Sets that fail TennisAnalyzer validation
+    size_t overlaps = 0;               // Negative rest gaps
+
+    bool valid() const { return invalidRecords == 0; }
+};
+
+/**
+ * @brief Reproducible source of synthetic sessions
+ *
+ * Session k depends only on the seed and k, never on how many sessions were
+ * generated before or on which thread, so workloads can be produced in
+ * parallel or in pieces and still match. Only the generator's own PRNG and
+ * correctly rounded IEEE-754 arithmetic (+, -, *, /, sqrt) are used, so a
+ * seed yields bit-identical sessions on every platform and standard library.
+ */
+class TENNIS_API WorkloadGenerator {
+public:
+    /**
+     * @throws std::invalid_argument if the configuration is inconsistent
+     */
+    explicit WorkloadGenerator(WorkloadConfig config = {});
+
+    /**
+     * @brief Generate session `index` into `out`, reusing its storage
+     */
+    void generate(uint64_t index, GeneratedSession& out) const;
+
+    /**
+     * @brief Generate the next session in sequence
+     */
+    GeneratedSession next();
+
+    /**
+     * @brief Append `count` sessions starting at index `first` to a columnar batch
+     *
+     * @return Number of appended sessions containing invalid records
+     */
+    size_t fillBatch(SessionBatch& batch, size_t count, uint64_t first = 0) const;
+
+    /**
+     * @brief Write `count` sessions starting at index `first` as session files
+     *
+     * Files are named `session_<index>.tpsf` inside `directory`, which must
+     * exist, with the index zero-padded to eight digits
+     * (`session_00000042.tpsf`) so names sort in index order. Invalid records
+     * are written unchanged.
+     *
+     * @return Paths of the written files, in index order
+     * @throws std::runtime_error if a file cannot be written
+     */
+    std::vector<std::string> writeFiles(const std::string& directory, size_t count, uint64_t first = 0) const;
+
+    const WorkloadConfig& config() const { return config_; }
+
+private:
+    WorkloadConfig config_;
+    uint64_t nextIndex_ = 0;
+};
+
+} // namespace tennis
+
+#endif // TENNIS_WORKLOAD_GENERATOR_HPP
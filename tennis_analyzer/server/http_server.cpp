@@ -0,0 +1,675 @@
+//
+//  http_server.cpp
+//  Tennis Analyzer HTTP Server
+//
+//  Implementation of the non-blocking HTTP/1.1 analysis server
+//
+
+#include "http_server.hpp"
+#include "json_reader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace tennis {
+
+// Request heads larger than this are rejected before the body is read
+constexpr size_t MAX_HEADER_BYTES = 64 * 1024;
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr int MAX_IOVECS = 64;
+
+struct HttpServer::Connection {
+    int fd = -1;
+    std::string input;
+    size_t consumed = 0;        // Bytes of `input` already parsed
+    bool closeAfterFlush = false;
+    ResponseWriter output;
+};
+
+// MARK: - Helpers
+
+static const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        default: return "Internal Server Error";
+    }
+}
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] + 32) : a[i];
+        char y = b[i] >= 'A' && b[i] <= 'Z' ? static_cast<char>(b[i] + 32) : b[i];
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+static void appendNumber(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        // JSON has no infinity (e.g. work/rest ratio with zero rest)
+        out += "null";
+        return;
+    }
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+static void appendEscaped(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+static void appendResult(std::string& out, const AnalysisResult& result) {
+    out += "{\"totalActiveTime\":";
+    appendNumber(out, result.totalActiveTime);
+    out += ",\"workRestRatio\":";
+    appendNumber(out, result.workRestRatio);
+    out += ",\"consistencyScore\":";
+    appendNumber(out, result.consistencyScore);
+    out += ",\"trainingDensityScore\":";
+    appendNumber(out, result.trainingDensityScore);
+    out += ",\"averageIntensity\":";
+    appendNumber(out, result.averageIntensity);
+    out += ",\"totalWorkVolume\":";
+    appendNumber(out, result.totalWorkVolume);
+    out += ",\"totalSets\":";
+    appendNumber(out, static_cast<double>(result.totalSets));
+    out += '}';
+}
+
+/**
+ * @brief Parse one `{"durations":[...],"intensities":[...]}` object
+ *
+ * Sizes and ranges are left for TennisAnalyzer::validateInputs to report.
+ */
+static bool parseSession(
+    JsonReader& reader,
+    std::vector<double>& durations,
+    std::vector<uint8_t>& intensities,
+    const char*& error
+) {
+    durations.clear();
+    intensities.clear();
+    std::string_view key;
+    double value;
+
+    if (!reader.beginObject()) {
+        error = "Expected a session object";
+        return false;
+    }
+    while (reader.nextMember(key)) {
+        if (key == "durations") {
+            if (!reader.beginArray()) {
+                break;
+            }
+            while (reader.nextElement() && reader.readNumber(value)) {
+                durations.push_back(value);
+            }
+        } else if (key == "intensities") {
+            if (!reader.beginArray()) {
+                break;
+            }
+            while (reader.nextElement() && reader.readNumber(value)) {
+                if (value < 0.0 || value > 255.0 || value != std::floor(value)) {
+                    error = "Intensities must be integers";
+                    return false;
+                }
+                intensities.push_back(static_cast<uint8_t>(value));
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    if (reader.failed()) {
+        error = "Malformed JSON";
+        return false;
+    }
+    return true;
+}
+
+// MARK: - ResponseWriter
+
+void ResponseWriter::commit(int status, size_t bodyOffset, bool keepAlive, const char* contentType,
+                            bool headOnly) {
+    const size_t bodyLength = bodies_.size() - bodyOffset;
+    char header[256];
+    int length = std::snprintf(
+        header, sizeof(header),
+        "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n",
+        status, statusText(status), contentType, bodyLength,
+        keepAlive ? "" : "Connection: close\r\n"
+    );
+
+    segments_.push_back({true, headers_.size(), static_cast<size_t>(length)});
+    headers_.append(header, static_cast<size_t>(length));
+    if (bodyLength > 0 && !headOnly) {
+        segments_.push_back({false, bodyOffset, bodyLength});
+    }
+}
+
+bool ResponseWriter::flush(int fd) {
+    while (pending()) {
+        iovec iov[MAX_IOVECS];
+        int count = 0;
+        for (size_t i = segmentIndex_; i < segments_.size() && count < MAX_IOVECS; ++i, ++count) {
+            const Segment& segment = segments_[i];
+            const std::string& source = segment.isHeader ? headers_ : bodies_;
+            size_t skip = (i == segmentIndex_) ? segmentSent_ : 0;
+            iov[count].iov_base = const_cast<char*>(source.data() + segment.offset + skip);
+            iov[count].iov_len = segment.length - skip;
+        }
+
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        size_t remaining = static_cast<size_t>(written);
+        while (remaining > 0 && pending()) {
+            size_t left = segments_[segmentIndex_].length - segmentSent_;
+            if (remaining >= left) {
+                remaining -= left;
+                ++segmentIndex_;
+                segmentSent_ = 0;
+            } else {
+                segmentSent_ += remaining;
+                remaining = 0;
+            }
+        }
+    }
+
+    // Everything went out: recycle the buffers (capacity is kept)
+    headers_.clear();
+    bodies_.clear();
+    segments_.clear();
+    segmentIndex_ = 0;
+    segmentSent_ = 0;
+    return true;
+}
+
+// MARK: - HttpServer
+
+HttpServer::HttpServer(HttpServerConfig config)
+    : config_(std::move(config)), readBuffer_(new char[READ_CHUNK]) {}
+
+HttpServer::~HttpServer() {
+    for (MetricsRegistry::CallbackId id : metricIds_) {
+        metricsRegistry().removeCallback(id);
+    }
+    for (auto& connection : connections_) {
+        close(connection->fd);
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+    }
+    for (int fd : wakeFds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void HttpServer::start() {
+    // Peers closing mid-response must surface as EPIPE, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (pipe(wakeFds_) != 0 || !setNonBlocking(wakeFds_[0]) || !setNonBlocking(wakeFds_[1])) {
+        throw std::runtime_error("Failed to create wake-up pipe");
+    }
+
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error("Failed to create listening socket");
+    }
+    int enable = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    if (inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("Invalid bind address: " + config_.bindAddress);
+    }
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd_, config_.listenBacklog) != 0 ||
+        !setNonBlocking(listenFd_)) {
+        throw std::runtime_error(
+            "Failed to listen on " + config_.bindAddress + ":" + std::to_string(config_.port) +
+            ": " + std::strerror(errno)
+        );
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort_ = ntohs(address.sin_port);
+
+    MetricsRegistry& registry = metricsRegistry();
+    metricIds_.push_back(registry.addCallback(
+        MetricType::Counter, "tennis_http_requests_total", "HTTP requests received", "",
+        [this] { return static_cast<double>(requests_.load(std::memory_order_relaxed)); }));
+    metricIds_.push_back(registry.addCallback(
+        MetricType::Gauge, "tennis_http_open_connections", "Open client connections", "",
+        [this] { return static_cast<double>(openConnections_.load(std::memory_order_relaxed)); }));
+    running_.store(true);
+}
+
+void HttpServer::stop() {
+    running_.store(false);
+    if (wakeFds_[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = write(wakeFds_[1], &byte, 1);
+        (void)ignored;
+    }
+}
+
+void HttpServer::run() {
+    std::vector<pollfd> fds;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        fds.clear();
+        fds.push_back({wakeFds_[0], POLLIN, 0});
+        fds.push_back({listenFd_, POLLIN, 0});
+        for (auto& connection : connections_) {
+            short events = connection->output.pending() ? POLLOUT : POLLIN;
+            fds.push_back({connection->fd, events, 0});
+        }
+
+        int ready = poll(fds.data(), static_cast<nfds_t>(fds.size()), -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("poll() failed");
+        }
+
+        // Connections are indexed from 2 in `fds`; accepting only appends, so
+        // walk existing connections before accepting new ones
+        size_t index = 0;
+        for (size_t i = 2; i < fds.size(); ++i) {
+            Connection& connection = *connections_[index];
+            bool keep = true;
+            if (fds[i].revents & (POLLERR | POLLNVAL)) {
+                keep = false;
+            } else {
+                if (fds[i].revents & (POLLIN | POLLHUP)) {
+                    keep = handleReadable(connection);
+                }
+                if (keep && connection.output.pending() && (fds[i].revents & POLLOUT)) {
+                    keep = connection.output.flush(connection.fd);
+                }
+                if (keep && connection.closeAfterFlush && !connection.output.pending()) {
+                    keep = false;
+                }
+            }
+
+            if (keep) {
+                ++index;
+            } else {
+                close(connection.fd);
+                connections_.erase(connections_.begin() + static_cast<std::ptrdiff_t>(index));
+                openConnections_.store(connections_.size(), std::memory_order_relaxed);
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            acceptConnections();
+        }
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wakeFds_[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+    }
+}
+
+void HttpServer::acceptConnections() {
+    while (true) {
+        int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            return; // EAGAIN, or a transient error that the next poll retries
+        }
+        if (connections_.size() >= config_.maxConnections || !setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connections_.push_back(std::move(connection));
+        openConnections_.store(connections_.size(), std::memory_order_relaxed);
+    }
+}
+
+bool HttpServer::handleReadable(Connection& connection) {
+    bool peerClosed = false;
+    while (true) {
+        // Growing the input by a whole chunk before reading would zero-fill
+        // it on every call; only the bytes that arrived are appended
+        ssize_t received = read(connection.fd, readBuffer_.get(), READ_CHUNK);
+        if (received > 0) {
+            connection.input.append(readBuffer_.get(), static_cast<size_t>(received));
+            if (static_cast<size_t>(received) < READ_CHUNK) {
+                break; // Drained for now; avoids an extra EAGAIN syscall
+            }
+            continue;
+        }
+        if (received == 0) {
+            peerClosed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    if (!processRequests(connection)) {
+        return false;
+    }
+    if (!connection.output.flush(connection.fd)) {
+        return false;
+    }
+    // A half-closed peer still gets the responses to what it already sent
+    return !peerClosed || connection.output.pending();
+}
+
+bool HttpServer::processRequests(Connection& connection) {
+    std::string& input = connection.input;
+
+    while (!connection.closeAfterFlush) {
+        std::string_view pendingData(input.data() + connection.consumed, input.size() - connection.consumed);
+        size_t headerEnd = pendingData.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos) {
+            if (pendingData.size() > MAX_HEADER_BYTES) {
+                sendError(connection, 431, "Request head too large", false);
+            }
+            break;
+        }
+
+        std::string_view head = pendingData.substr(0, headerEnd);
+        size_t lineEnd = head.find("\r\n");
+        std::string_view requestLine = head.substr(0, lineEnd);
+        size_t firstSpace = requestLine.find(' ');
+        size_t lastSpace = requestLine.rfind(' ');
+        if (firstSpace == std::string_view::npos || lastSpace == firstSpace) {
+            sendError(connection, 400, "Malformed request line", false);
+            break;
+        }
+        std::string_view method = requestLine.substr(0, firstSpace);
+        std::string_view path = requestLine.substr(firstSpace + 1, lastSpace - firstSpace - 1);
+        std::string_view version = requestLine.substr(lastSpace + 1);
+
+        bool keepAlive = (version == "HTTP/1.1");
+        size_t contentLength = 0;
+        bool sawContentLength = false;
+        bool conflictingLengths = false;
+        bool chunked = false;
+
+        size_t lineStart = lineEnd == std::string_view::npos ? head.size() : lineEnd + 2;
+        while (lineStart < head.size()) {
+            size_t next = head.find("\r\n", lineStart);
+            std::string_view line = head.substr(lineStart, next == std::string_view::npos ? std::string_view::npos : next - lineStart);
+            lineStart = next == std::string_view::npos ? head.size() : next + 2;
+
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+            if (equalsIgnoreCase(name, "content-length")) {
+                size_t length = 0;
+                for (char c : value) {
+                    if (c < '0' || c > '9' || length > config_.maxRequestBytes) {
+                        length = config_.maxRequestBytes + 1;
+                        break;
+                    }
+                    length = length * 10 + static_cast<size_t>(c - '0');
+                }
+                // Repeats must agree, or the body's end is ambiguous (request smuggling)
+                conflictingLengths = conflictingLengths || (sawContentLength && length != contentLength);
+                contentLength = length;
+                sawContentLength = true;
+            } else if (equalsIgnoreCase(name, "connection")) {
+                if (equalsIgnoreCase(value, "close")) {
+                    keepAlive = false;
+                } else if (equalsIgnoreCase(value, "keep-alive")) {
+                    keepAlive = true;
+                }
+            } else if (equalsIgnoreCase(name, "transfer-encoding")) {
+                chunked = !equalsIgnoreCase(value, "identity");
+            }
+        }
+
+        if (conflictingLengths) {
+            sendError(connection, 400, "Conflicting Content-Length headers", false);
+            break;
+        }
+        if (chunked) {
+            sendError(connection, 501, "Chunked request bodies are not supported", false);
+            break;
+        }
+        if (contentLength > config_.maxRequestBytes) {
+            sendError(connection, 413, "Request body too large", false);
+            break;
+        }
+
+        size_t requestSize = headerEnd + 4 + contentLength;
+        if (pendingData.size() < requestSize) {
+            break; // Wait for the rest of the body
+        }
+
+        std::string_view body = pendingData.substr(headerEnd + 4, contentLength);
+        dispatch(connection, method, path, body, keepAlive);
+        connection.consumed += requestSize;
+        if (!keepAlive) {
+            connection.closeAfterFlush = true;
+        }
+    }
+
+    // Drop parsed bytes; pipelined leftovers move to the front
+    if (connection.consumed > 0) {
+        input.erase(0, connection.consumed);
+        connection.consumed = 0;
+    }
+    return true;
+}
+
+void HttpServer::dispatch(
+    Connection& connection,
+    std::string_view method,
+    std::string_view path,
+    std::string_view body,
+    bool keepAlive
+) {
+    requests_.store(requests_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (path == "/analyze") {
+        if (method != "POST") {
+            sendError(connection, 405, "Use POST", keepAlive);
+            return;
+        }
+        handleAnalyze(connection, body, keepAlive);
+    } else if (path == "/analyze/batch") {
+        if (method != "POST") {
+            sendError(connection, 405, "Use POST", keepAlive);
+            return;
+        }
+        handleBatch(connection, body, keepAlive);
+    } else if (path == "/health") {
+        if (method != "GET" && method != "HEAD") {
+            sendError(connection, 405, "Use GET", keepAlive);
+            return;
+        }
+        std::string& out = connection.output.bodyBuffer();
+        size_t offset = out.size();
+        out += "{\"status\":\"ok\"}";
+        connection.output.commit(200, offset, keepAlive, "application/json", method == "HEAD");
+    } else if (path == "/metrics") {
+        if (method != "GET") {
+            sendError(connection, 405, "Use GET", keepAlive);
+            return;
+        }
+        handleMetrics(connection, keepAlive);
+    } else {
+        sendError(connection, 404, "Unknown endpoint", keepAlive);
+    }
+}
+
+void HttpServer::handleAnalyze(Connection& connection, std::string_view body, bool keepAlive) {
+    JsonReader reader(body.data(), body.size());
+    const char* error = nullptr;
+    if (!parseSession(reader, durations_, intensities_, error) || !reader.finish()) {
+        sendError(connection, 400, error ? error : "Malformed JSON", keepAlive);
+        return;
+    }
+
+    AnalysisResult result;
+    ValidationResult validation = analyzer_.tryAnalyze(durations_, intensities_, result);
+    if (!validation.ok()) {
+        sendError(connection, 400, TennisAnalyzer::validationMessage(validation), keepAlive);
+        return;
+    }
+
+    std::string& out = connection.output.bodyBuffer();
+    size_t offset = out.size();
+    appendResult(out, result);
+    connection.output.commit(200, offset, keepAlive);
+}
+
+void HttpServer::handleBatch(Connection& connection, std::string_view body, bool keepAlive) {
+    JsonReader reader(body.data(), body.size());
+    const char* error = nullptr;
+    std::string_view key;
+    bool sawSessions = false;
+
+    batch_.clear();
+    if (reader.beginObject()) {
+        while (reader.nextMember(key)) {
+            if (key != "sessions") {
+                reader.skipValue();
+                continue;
+            }
+            sawSessions = true;
+            if (!reader.beginArray()) {
+                break;
+            }
+            while (reader.nextElement()) {
+                if (!parseSession(reader, durations_, intensities_, error)) {
+                    sendError(connection, 400, error, keepAlive);
+                    return;
+                }
+                if (durations_.size() != intensities_.size()) {
+                    sendError(connection, 400, "Durations and intensities vectors must have the same size", keepAlive);
+                    return;
+                }
+                batch_.addSession(durations_.data(), intensities_.data(), durations_.size());
+            }
+        }
+    }
+    if (!reader.finish() || !sawSessions) {
+        sendError(connection, 400, sawSessions ? "Malformed JSON" : "Missing \"sessions\" array", keepAlive);
+        return;
+    }
+
+    analyzeBatch(batch_, batchResult_);
+
+    std::string& out = connection.output.bodyBuffer();
+    size_t offset = out.size();
+    out += "{\"results\":[";
+    for (size_t i = 0; i < batchResult_.results.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        if (batchResult_.ok(i)) {
+            appendResult(out, batchResult_.results[i]);
+        } else {
+            out += "{\"error\":";
+            appendEscaped(out, batchResult_.errors[i]);
+            out += '}';
+        }
+    }
+    out += "],\"failedSessions\":";
+    appendNumber(out, static_cast<double>(batchResult_.failedSessions));
+    out += '}';
+    connection.output.commit(200, offset, keepAlive);
+}
+
+void HttpServer::handleMetrics(Connection& connection, bool keepAlive) {
+    std::string& out = connection.output.bodyBuffer();
+    size_t offset = out.size();
+    metricsRegistry().writePrometheus(out);
+    connection.output.commit(200, offset, keepAlive, PROMETHEUS_CONTENT_TYPE);
+}
+
+void HttpServer::sendError(Connection& connection, int status, std::string_view message, bool keepAlive) {
+    std::string& out = connection.output.bodyBuffer();
+    size_t offset = out.size();
+    out += "{\"error\":";
+    appendEscaped(out, message);
+    out += '}';
+    connection.output.commit(status, offset, keepAlive);
+    if (!keepAlive) {
+        connection.closeAfterFlush = true;
+    }
+}
+
+} // namespace tennis
@@ -0,0 +1,164 @@
+//
+//  http_server.hpp
+//  Tennis Analyzer HTTP Server
+//
+//  Minimal HTTP/1.1 JSON endpoint for the tennis analyzer (POSIX only)
+//
+
+#ifndef TENNIS_HTTP_SERVER_HPP
+#define TENNIS_HTTP_SERVER_HPP
+
+#include "tennis_analyzer.hpp"
+#include "session_batch.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tennis {
+
+/**
+ * @brief Server configuration
+ */
+struct HttpServerConfig {
+    std::string bindAddress = "127.0.0.1"; // Loopback only by default
+    uint16_t port = 8080;                  // 0 picks an ephemeral port
+    size_t maxConnections = 1024;
+    size_t maxRequestBytes = 16 * 1024 * 1024;
+    int listenBacklog = 512;
+};
+
+/**
+ * @brief Outgoing data for one connection
+ *
+ * Response headers and bodies are formatted directly into two append-only
+ * buffers and sent with a single gather write, so a body is never copied
+ * after it has been serialized. Pipelined responses accumulate in the same
+ * buffers and leave in one writev() call.
+ */
+class ResponseWriter {
+public:
+    /**
+     * @brief Append a complete response
+     *
+     * @param status HTTP status code
+     * @param bodyOffset Offset of the body inside bodyBuffer()
+     * @param keepAlive Whether the connection stays open afterwards
+     * @param contentType Content-Type of the body
+     * @param headOnly Answer a HEAD request: the headers describe the body,
+     *        but it is not sent
+     */
+    void commit(int status, size_t bodyOffset, bool keepAlive, const char* contentType = "application/json",
+                bool headOnly = false);
+
+    /**
+     * @brief Buffer that response bodies are serialized into
+     */
+    std::string& bodyBuffer() { return bodies_; }
+
+    /**
+     * @brief Write as much pending data as the socket accepts
+     *
+     * @return false on a fatal socket error
+     */
+    bool flush(int fd);
+
+    bool pending() const { return segmentIndex_ < segments_.size(); }
+
+private:
+    struct Segment {
+        bool isHeader;
+        size_t offset;
+        size_t length;
+    };
+
+    std::string headers_;
+    std::string bodies_;
+    std::vector<Segment> segments_;
+    size_t segmentIndex_ = 0; // First segment not fully written
+    size_t segmentSent_ = 0;  // Bytes of that segment already written
+};
+
+/**
+ * @brief Single-threaded, non-blocking HTTP/1.1 analysis server
+ *
+ * Endpoints:
+ * - `POST /analyze` with `{"durations":[...],"intensities":[...]}`
+ * - `POST /analyze/batch` with `{"sessions":[{...}, ...]}`
+ * - `GET /health` (or `HEAD`)
+ * - `GET /metrics` (Prometheus text format, see metricsRegistry())
+ *
+ * Connections are kept alive unless the client asks otherwise, and
+ * pipelined requests are answered in order from a single read buffer.
+ */
+class HttpServer {
+public:
+    explicit HttpServer(HttpServerConfig config = {});
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /**
+     * @brief Bind and listen
+     *
+     * @throws std::runtime_error if the socket cannot be set up
+     */
+    void start();
+
+    /**
+     * @brief Run the event loop until stop() is called
+     */
+    void run();
+
+    /**
+     * @brief Ask the event loop to exit (safe from any thread)
+     */
+    void stop();
+
+    /**
+     * @brief Port actually bound (useful with port 0)
+     */
+    uint16_t port() const { return boundPort_; }
+
+private:
+    struct Connection;
+
+    void acceptConnections();
+    bool handleReadable(Connection& connection);
+    bool processRequests(Connection& connection);
+    void dispatch(Connection& connection, std::string_view method, std::string_view path,
+                  std::string_view body, bool keepAlive);
+    void handleAnalyze(Connection& connection, std::string_view body, bool keepAlive);
+    void handleBatch(Connection& connection, std::string_view body, bool keepAlive);
+    void handleMetrics(Connection& connection, bool keepAlive);
+    void sendError(Connection& connection, int status, std::string_view message, bool keepAlive);
+
+    HttpServerConfig config_;
+    int listenFd_ = -1;
+    int wakeFds_[2] = {-1, -1}; // Self-pipe used by stop()
+    uint16_t boundPort_ = 0;
+    std::atomic<bool> running_{false};
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    // Sampled by metricsRegistry(), possibly from another thread
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<size_t> openConnections_{0};
+    std::vector<MetricsRegistry::CallbackId> metricIds_;
+
+    // Request scratch space, reused across requests
+    std::unique_ptr<char[]> readBuffer_; // Socket reads land here, then join a connection's input
+    TennisAnalyzer analyzer_;
+    std::vector<double> durations_;
+    std::vector<uint8_t> intensities_;
+    SessionBatch batch_;
+    BatchResult batchResult_;
+};
+
+} // namespace tennis
+
+#endif // TENNIS_HTTP_SERVER_HPP
@@ -0,0 +1,53 @@
+//
+//  main.cpp
+//  Tennis Analyzer HTTP Server
+//
+//  Usage: tennis_analyzer_server [port] [bind-address]
+//
+
+#include "http_server.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+
+using namespace tennis;
+
+static HttpServer* activeServer = nullptr;
+
+static void handleSignal(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+int main(int argc, char** argv) {
+    HttpServerConfig config;
+    if (argc > 1) {
+        config.port = static_cast<uint16_t>(std::atoi(argv[1]));
+    }
+    if (argc > 2) {
+        config.bindAddress = argv[2];
+    }
+
+    try {
+        HttpServer server(config);
+        server.start();
+        activeServer = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+
+        std::cout << "Tennis Analyzer server listening on http://"
+                  << config.bindAddress << ":" << server.port() << "\n";
+        std::cout << "  POST /analyze        {\"durations\":[...],\"intensities\":[...]}\n";
+        std::cout << "  POST /analyze/batch  {\"sessions\":[...]}\n";
+        std::cout << "  GET  /health (or HEAD)\n";
+        std::cout << "  GET  /metrics\n";
+
+        server.run();
+        activeServer = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+//
+//  server_bench.cpp
+//  Tennis Analyzer HTTP Server
+//
+//  Loopback throughput benchmark: runs the server in-process and drives it
+//  with keep-alive connections carrying pipelined requests.
+//
+//  Usage: tennis_analyzer_server_bench [--seconds S] [--connections C]
+//                                      [--depth D] [--endpoint analyze|batch]
+//                                      [--min-rps N]
+//
+
+#include "http_server.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace tennis;
+
+namespace {
+
+struct Options {
+    double seconds = 3.0;
+    int connections = 8;
+    int depth = 16;
+    bool batch = false;
+    double minRps = 0.0;
+};
+
+std::string makeRequest(bool batch) {
+    const std::string session =
+        "{\"durations\":[180,240,300,240,180],\"intensities\":[2,3,5,4,2]}";
+    std::string body;
+    if (batch) {
+        body = "{\"sessions\":[";
+        for (int i = 0; i < 8; ++i) {
+            body += (i ? "," : "") + session;
+        }
+        body += "]}";
+    } else {
+        body = session;
+    }
+    return std::string("POST ") + (batch ? "/analyze/batch" : "/analyze") + " HTTP/1.1\r\n"
+           "Host: localhost\r\nContent-Type: application/json\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+int connectTo(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::perror("connect");
+        std::exit(1);
+    }
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Read exactly `count` responses; returns how many were 200 OK
+ */
+long readResponses(int fd, int count, std::string& buffer) {
+    long ok = 0;
+    int parsed = 0;
+    char chunk[65536];
+    while (parsed < count) {
+        size_t headerEnd = buffer.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            size_t lengthAt = buffer.find("Content-Length: ");
+            size_t bodyLength = std::strtoul(buffer.c_str() + lengthAt + 16, nullptr, 10);
+            size_t total = headerEnd + 4 + bodyLength;
+            if (buffer.size() >= total) {
+                ok += buffer.compare(0, 12, "HTTP/1.1 200") == 0;
+                buffer.erase(0, total);
+                ++parsed;
+                continue;
+            }
+        }
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            std::cerr << "Connection closed by server\n";
+            std::exit(1);
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--seconds") options.seconds = std::atof(argv[i + 1]);
+        else if (flag == "--connections") options.connections = std::atoi(argv[i + 1]);
+        else if (flag == "--depth") options.depth = std::atoi(argv[i + 1]);
+        else if (flag == "--endpoint") options.batch = std::string(argv[i + 1]) == "batch";
+        else if (flag == "--min-rps") options.minRps = std::atof(argv[i + 1]);
+        else {
+            std::cerr << "Unknown option " << flag << "\n";
+            return 2;
+        }
+    }
+
+    HttpServerConfig config;
+    config.port = 0;
+    HttpServer server(config);
+    server.start();
+    std::thread serverThread([&server] { server.run(); });
+
+    // One pipelined burst per connection per round
+    std::string burst;
+    const std::string request = makeRequest(options.batch);
+    for (int i = 0; i < options.depth; ++i) {
+        burst += request;
+    }
+
+    std::vector<int> fds;
+    std::vector<std::string> buffers(static_cast<size_t>(options.connections));
+    for (int i = 0; i < options.connections; ++i) {
+        fds.push_back(connectTo(server.port()));
+    }
+
+    long requests = 0;
+    long ok = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(options.seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (int fd : fds) {
+            if (!sendAll(fd, burst)) {
+                std::cerr << "Send failed\n";
+                return 1;
+            }
+        }
+        for (size_t i = 0; i < fds.size(); ++i) {
+            ok += readResponses(fds[i], options.depth, buffers[i]);
+        }
+        requests += static_cast<long>(options.depth) * options.connections;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int fd : fds) {
+        close(fd);
+    }
+    server.stop();
+    serverThread.join();
+
+    double rps = static_cast<double>(requests) / elapsed;
+    std::printf("endpoint=%s connections=%d depth=%d requests=%ld ok=%ld elapsed=%.2fs\n",
+                options.batch ? "/analyze/batch" : "/analyze", options.connections,
+                options.depth, requests, ok, elapsed);
+    std::printf("throughput: %.0f requests/sec\n", rps);
+
+    if (ok != requests) {
+        std::cerr << "FAIL: " << (requests - ok) << " non-200 responses\n";
+        return 1;
+    }
+    if (options.minRps > 0.0 && rps < options.minRps) {
+        std::cerr << "FAIL: throughput below --min-rps " << options.minRps << "\n";
+        return 1;
+    }
+    return 0;
+}
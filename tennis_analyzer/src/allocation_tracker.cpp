@@ -0,0 +1,222 @@
+//
+//  allocation_tracker.cpp
+//  Tennis Training Session Analyzer
+//
+//  Replacement global operator new/delete that counts allocations.
+//  Only compiled in with TENNIS_ANALYZER_TRACK_ALLOCATIONS=1.
+//
+
+#include "allocation_tracker.hpp"
+
+#if TENNIS_ANALYZER_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace tennis {
+
+namespace {
+
+// Plain thread_local data needs no constructor, so it is safe to touch
+// from operator new at any point in a thread's life
+thread_local AllocationCounts threadCounts;
+
+std::atomic<uint64_t> processAllocations{0};
+std::atomic<uint64_t> processBytes{0};
+
+struct StageCounters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> allocatingCalls{0};
+    std::atomic<uint64_t> maxPerCall{0};
+};
+
+StageCounters stageCounters[LATENCY_STAGE_COUNT];
+
+void countAllocation(std::size_t size) {
+    ++threadCounts.allocations;
+    threadCounts.bytes += size;
+    processAllocations.fetch_add(1, std::memory_order_relaxed);
+    processBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size) {
+    countAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    countAllocation(size);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc needs a size that is a multiple of the alignment
+    const std::size_t rounded = (size + align - 1) / align * align;
+    while (true) {
+#if defined(_WIN32)
+        void* p = _aligned_malloc(rounded ? rounded : align, align);
+#else
+        void* p = std::aligned_alloc(align, rounded ? rounded : align);
+#endif
+        if (p) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void releaseAligned(void* p) noexcept {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+AllocationCounts threadAllocationCounts() {
+    return threadCounts;
+}
+
+AllocationCounts processAllocationCounts() {
+    return {processAllocations.load(std::memory_order_relaxed), processBytes.load(std::memory_order_relaxed)};
+}
+
+StageAllocationStats stageAllocationStats(LatencyStage stage) {
+    const StageCounters& c = stageCounters[static_cast<size_t>(stage)];
+    StageAllocationStats stats;
+    stats.calls = c.calls.load(std::memory_order_relaxed);
+    stats.allocations = c.allocations.load(std::memory_order_relaxed);
+    stats.bytes = c.bytes.load(std::memory_order_relaxed);
+    stats.allocatingCalls = c.allocatingCalls.load(std::memory_order_relaxed);
+    stats.maxPerCall = c.maxPerCall.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void resetAllocationStats() {
+    for (StageCounters& c : stageCounters) {
+        c.calls.store(0, std::memory_order_relaxed);
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+        c.allocatingCalls.store(0, std::memory_order_relaxed);
+        c.maxPerCall.store(0, std::memory_order_relaxed);
+    }
+}
+
+AllocationScope::AllocationScope(LatencyStage stage)
+    : stage_(stage), start_(threadCounts) {}
+
+AllocationScope::~AllocationScope() {
+    const uint64_t allocations = threadCounts.allocations - start_.allocations;
+    StageCounters& c = stageCounters[static_cast<size_t>(stage_)];
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    if (allocations == 0) {
+        return;
+    }
+    c.allocations.fetch_add(allocations, std::memory_order_relaxed);
+    c.bytes.fetch_add(threadCounts.bytes - start_.bytes, std::memory_order_relaxed);
+    c.allocatingCalls.fetch_add(1, std::memory_order_relaxed);
+    uint64_t previous = c.maxPerCall.load(std::memory_order_relaxed);
+    while (allocations > previous &&
+           !c.maxPerCall.compare_exchange_weak(previous, allocations, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace tennis
+
+// MARK: - Replaceable global allocation functions
+
+void* operator new(std::size_t size) {
+    return tennis::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return tennis::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return tennis::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return tennis::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return tennis::allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return tennis::allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    tennis::releaseAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    tennis::releaseAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    tennis::releaseAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    tennis::releaseAligned(p);
+}
+
+#endif // TENNIS_ANALYZER_TRACK_ALLOCATIONS
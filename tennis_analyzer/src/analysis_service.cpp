@@ -0,0 +1,410 @@
+//
+//  analysis_service.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the thread-safe analysis service
+//
+
+#include "analysis_service.hpp"
+#include "allocation_tracker.hpp"
+#include "latency_histogram.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+namespace tennis {
+
+// Weight of the newest sample in the smoothed delay and cost estimates
+constexpr double EWMA_ALPHA = 0.05;
+
+// Time constant of the interactive delay's decay while no interactive work
+// is queued, in latency targets: a stale reading halves in about 14 of them
+constexpr double DELAY_DECAY_TARGETS = 20.0;
+
+// Per-request overhead added to the per-set cost estimate
+constexpr double REQUEST_OVERHEAD_NS = 500.0;
+
+/**
+ * @brief One computation that other callers can join
+ *
+ * The inputs are borrowed from the leading caller, which keeps them alive
+ * until the entry has been removed from the in-flight table.
+ */
+struct AnalysisService::InFlight {
+    const double* durations;
+    const uint8_t* intensities;
+    size_t count;
+    std::promise<AnalysisResult> promise;
+    std::shared_future<AnalysisResult> result;
+};
+
+/**
+ * @brief A queued request owned by the worker pool
+ */
+struct AnalysisService::Task {
+    std::vector<double> durations;
+    std::vector<uint8_t> intensities;
+    RequestPriority priority;
+    std::promise<AnalysisResult> promise;
+    Clock::time_point enqueued;
+    double costNs;
+    bool deferred;
+};
+
+AnalysisService::AnalysisService(AnalysisServiceConfig config)
+    : config_(config),
+      interactiveDelayNs_(EWMA_ALPHA, std::chrono::duration_cast<Clock::duration>(
+                                          config.latencyTarget * DELAY_DECAY_TARGETS)) {
+    registerMetrics();
+}
+
+AnalysisService::~AnalysisService() {
+    // Waits for any exposition that is sampling this service
+    for (MetricsRegistry::CallbackId id : metricIds_) {
+        metricsRegistry().removeCallback(id);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopping_ = true;
+    }
+    queueReady_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void AnalysisService::registerMetrics() {
+    static std::atomic<unsigned> nextServiceIndex{0};
+    const std::string label = "service=\"" + std::to_string(nextServiceIndex.fetch_add(1)) + "\"";
+    MetricsRegistry& registry = metricsRegistry();
+
+    auto add = [&](MetricType type, const char* name, const char* help, const std::string& labels,
+                   std::function<double()> sample) {
+        metricIds_.push_back(registry.addCallback(type, name, help, labels, std::move(sample)));
+    };
+    add(MetricType::Counter, "tennis_service_computations_total", "Analyses executed by the service", label,
+        [this] { return static_cast<double>(stats().computations); });
+    add(MetricType::Counter, "tennis_service_coalesced_total",
+        "Requests answered by an identical in-flight computation", label,
+        [this] { return static_cast<double>(stats().coalesced); });
+    add(MetricType::Counter, "tennis_service_shed_total", "Submitted requests rejected by admission control",
+        label, [this] { return static_cast<double>(stats().shed); });
+    add(MetricType::Counter, "tennis_service_deferred_total",
+        "Batch dispatches postponed because of interactive load", label,
+        [this] { return static_cast<double>(stats().deferred); });
+    add(MetricType::Gauge, "tennis_service_queue_depth", "Requests waiting for a worker",
+        label + ",priority=\"interactive\"", [this] { return static_cast<double>(stats().queuedInteractive); });
+    add(MetricType::Gauge, "tennis_service_queue_depth", "Requests waiting for a worker",
+        label + ",priority=\"batch\"", [this] { return static_cast<double>(stats().queuedBatch); });
+    add(MetricType::Gauge, "tennis_service_interactive_queue_delay_seconds",
+        "Smoothed queueing delay of interactive requests", label,
+        [this] { return stats().interactiveQueueDelayUs / 1e6; });
+    add(MetricType::Gauge, "tennis_service_estimated_seconds_per_set", "Learned per-set analysis cost", label,
+        [this] { return stats().estimatedNsPerSet / 1e9; });
+}
+
+static uint64_t mix(uint64_t h, uint64_t value) {
+    h ^= value;
+    h *= 0x100000001b3ULL; // FNV-1a prime
+    return h;
+}
+
+static uint64_t hashColumns(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount
+) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ durationCount;
+    for (size_t i = 0; i < durationCount; ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, &durations[i], sizeof(bits));
+        h = mix(h, bits);
+    }
+    for (size_t i = 0; i < intensityCount; ++i) {
+        h = mix(h, intensities[i]);
+    }
+
+    // Final avalanche so the low bits used for bucketing are well mixed
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t AnalysisService::hashInputs(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) {
+    return hashColumns(durations.data(), durations.size(), intensities.data(), intensities.size());
+}
+
+uint64_t AnalysisService::hashInputs(const double* durations, const uint8_t* intensities, size_t count) {
+    return hashColumns(durations, count, intensities, count);
+}
+
+AnalysisResult AnalysisService::analyze(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) {
+    if (durations.size() != intensities.size()) {
+        // Always rejected, so there is nothing to share
+        computations_.fetch_add(1, std::memory_order_relaxed);
+        TennisAnalyzer analyzer;
+        return analyzer.analyze(durations, intensities);
+    }
+    return analyze(durations.data(), intensities.data(), durations.size());
+}
+
+AnalysisResult AnalysisService::analyze(const double* durations, const uint8_t* intensities, size_t count) {
+    const uint64_t key = hashInputs(durations, intensities, count);
+    std::shared_ptr<InFlight> entry;
+    bool leader = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto range = inFlight_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            const InFlight& candidate = *it->second;
+            if (candidate.count == count && std::equal(durations, durations + count, candidate.durations) &&
+                std::equal(intensities, intensities + count, candidate.intensities)) {
+                entry = it->second;
+                break;
+            }
+        }
+
+        if (entry) {
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            entry = std::make_shared<InFlight>();
+            entry->durations = durations;
+            entry->intensities = intensities;
+            entry->count = count;
+            entry->result = entry->promise.get_future().share();
+            inFlight_.emplace(key, entry);
+            leader = true;
+        }
+    }
+
+    if (!leader) {
+        // Follower: wait for the leader's result (rethrows its exception)
+        return entry->result.get();
+    }
+
+    computations_.fetch_add(1, std::memory_order_relaxed);
+    std::exception_ptr error;
+    AnalysisResult result{};
+    try {
+        TennisAnalyzer analyzer;
+        const ValidationResult validation = analyzer.tryAnalyze(durations, intensities, count, result);
+        if (!validation.ok()) {
+            throw std::invalid_argument(TennisAnalyzer::validationMessage(validation));
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Unpublish before completing so no new follower can compare against
+    // inputs that are about to go out of scope
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto range = inFlight_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == entry) {
+                inFlight_.erase(it);
+                break;
+            }
+        }
+    }
+
+    if (error) {
+        entry->promise.set_exception(error);
+        std::rethrow_exception(error);
+    }
+    entry->promise.set_value(result);
+    return result;
+}
+
+std::future<AnalysisResult> AnalysisService::submit(
+    std::vector<double> durations,
+    std::vector<uint8_t> intensities,
+    RequestPriority priority
+) {
+    std::call_once(workersStarted_, [this] { startWorkers(); });
+
+    Task task;
+    task.costNs = 0.0;
+    task.durations = std::move(durations);
+    task.intensities = std::move(intensities);
+    task.priority = priority;
+    task.enqueued = Clock::now();
+    task.deferred = false;
+    std::future<AnalysisResult> future = task.promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        task.costNs = estimateCostNs(task.durations.size());
+
+        const bool interactive = priority == RequestPriority::Interactive;
+        const size_t limit = interactive ? config_.maxInteractiveQueue : config_.maxBatchQueue;
+        std::deque<Task>& queue = interactive ? interactiveQueue_ : batchQueue_;
+
+        if (stopping_ || queue.size() >= limit) {
+            ++shed_;
+            task.promise.set_exception(std::make_exception_ptr(ServiceOverloaded(
+                stopping_ ? "Analysis service is shutting down" : "Analysis queue is full"
+            )));
+            return future;
+        }
+        if (interactive) {
+            interactiveBacklogNs_ += task.costNs;
+        }
+        queue.push_back(std::move(task));
+    }
+    queueReady_.notify_one();
+    return future;
+}
+
+void AnalysisService::startWorkers() {
+    workerCount_ = config_.workerThreads;
+    if (workerCount_ == 0) {
+        workerCount_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(workerCount_);
+    for (size_t i = 0; i < workerCount_; ++i) {
+        workers_.emplace_back([this, i] {
+            setTraceThreadName("analysis-worker-" + std::to_string(i));
+            workerLoop();
+        });
+    }
+}
+
+double AnalysisService::estimateCostNs(size_t sets) const {
+    return REQUEST_OVERHEAD_NS + nsPerSet_ * static_cast<double>(sets);
+}
+
+double AnalysisService::projectedInteractiveDelayNs() const {
+    // What a newly arriving interactive request would wait: the smoothed
+    // recent delay, or the queued backlog spread over the workers if larger
+    double backlog = interactiveBacklogNs_ / static_cast<double>(std::max<size_t>(1, workerCount_));
+    return std::max(interactiveDelayNs_.value(), backlog);
+}
+
+bool AnalysisService::popTask(std::unique_lock<std::mutex>& lock, Task& task) {
+    const double targetNs = std::chrono::duration<double, std::nano>(config_.latencyTarget).count();
+    const size_t reserved = std::min(config_.reservedInteractiveWorkers, workerCount_ - 1);
+    const size_t batchLimit = workerCount_ - reserved;
+
+    while (true) {
+        const Clock::time_point now = Clock::now();
+
+        if (!interactiveQueue_.empty()) {
+            task = std::move(interactiveQueue_.front());
+            interactiveQueue_.pop_front();
+            interactiveBacklogNs_ = std::max(0.0, interactiveBacklogNs_ - task.costNs);
+            double delayNs = std::chrono::duration<double, std::nano>(now - task.enqueued).count();
+            interactiveDelayNs_.addSample(delayNs, now);
+            return true;
+        }
+
+        // The interactive queue is empty, so the smoothed delay only
+        // describes the past; it decays with the time since the last update,
+        // however often workers wake up to look at it
+        interactiveDelayNs_.decay(now);
+
+        // Shed batch work that has waited too long, or everything on shutdown
+        while (!batchQueue_.empty() &&
+               (stopping_ || now - batchQueue_.front().enqueued > config_.maxBatchDeferral)) {
+            batchQueue_.front().promise.set_exception(std::make_exception_ptr(ServiceOverloaded(
+                stopping_ ? "Analysis service is shutting down" : "Batch request deferred past its limit"
+            )));
+            batchQueue_.pop_front();
+            ++shed_;
+        }
+
+        if (!batchQueue_.empty()) {
+            Task& next = batchQueue_.front();
+            // Without a reserved worker a running batch job blocks new
+            // interactive requests, so it must fit in the latency budget
+            bool fitsBudget = reserved > 0
+                ? projectedInteractiveDelayNs() <= targetNs
+                : projectedInteractiveDelayNs() + next.costNs <= targetNs;
+            if (runningBatch_ < batchLimit && fitsBudget) {
+                task = std::move(next);
+                batchQueue_.pop_front();
+                ++runningBatch_;
+                return true;
+            }
+            if (!next.deferred) {
+                next.deferred = true;
+                ++deferred_;
+            }
+        } else if (stopping_) {
+            return false;
+        }
+
+        if (batchQueue_.empty()) {
+            queueReady_.wait(lock);
+        } else {
+            // Re-evaluate deferred batch work as the load estimate decays
+            queueReady_.wait_for(lock, config_.latencyTarget);
+        }
+    }
+}
+
+void AnalysisService::workerLoop() {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    Task task;
+    while (popTask(lock, task)) {
+        lock.unlock();
+
+        const Clock::time_point start = Clock::now();
+        const uint64_t traceStartNs = tracingActive() ? traceNow() : 0;
+        recordLatency(LatencyStage::ServiceQueueWait, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - task.enqueued).count()));
+        {
+            TENNIS_ALLOCATION_SCOPE(ServiceExecute);
+            try {
+                task.promise.set_value(analyze(task.durations, task.intensities));
+            } catch (...) {
+                task.promise.set_exception(std::current_exception());
+            }
+        }
+        const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        const size_t sets = task.durations.size();
+        recordLatency(LatencyStage::ServiceExecute, static_cast<uint64_t>(elapsedNs));
+        if (traceStartNs != 0) {
+            recordTraceEvent(task.priority == RequestPriority::Batch ? "service_batch_task" : "service_task",
+                             traceStartNs, traceNow(), TRACE_NO_SESSION, static_cast<uint32_t>(sets),
+                             "queue_wait_ns", static_cast<uint64_t>(
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(start - task.enqueued).count()));
+        }
+
+        lock.lock();
+        if (sets > 0) {
+            double sample = std::max(0.0, elapsedNs - REQUEST_OVERHEAD_NS) / static_cast<double>(sets);
+            nsPerSet_ += EWMA_ALPHA * (sample - nsPerSet_);
+        }
+        if (task.priority == RequestPriority::Batch) {
+            --runningBatch_;
+            queueReady_.notify_one();
+        }
+    }
+}
+
+AnalysisService::Stats AnalysisService::stats() const {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return {
+        computations_.load(std::memory_order_relaxed),
+        coalesced_.load(std::memory_order_relaxed),
+        shed_,
+        deferred_,
+        interactiveQueue_.size(),
+        batchQueue_.size(),
+        interactiveDelayNs_.value() / 1000.0,
+        nsPerSet_
+    };
+}
+
+} // namespace tennis
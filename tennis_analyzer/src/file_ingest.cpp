@@ -0,0 +1,526 @@
+//
+//  file_ingest.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the bulk session file reader
+//
+
+#include "file_ingest.hpp"
+#include "scratch_arena.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define TENNIS_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace tennis {
+
+constexpr size_t BUFFER_ALIGNMENT = 4096;
+
+struct FileIngestor::AlignedBuffer {
+    struct Free {
+        void operator()(unsigned char* p) const { std::free(p); }
+    };
+    std::unique_ptr<unsigned char, Free> data;
+};
+
+FileIngestor::AlignedBuffer FileIngestor::allocateBuffer(size_t size) {
+    void* memory = nullptr;
+    if (posix_memalign(&memory, BUFFER_ALIGNMENT, size) != 0) {
+        throw std::bad_alloc();
+    }
+    AlignedBuffer buffer;
+    buffer.data.reset(static_cast<unsigned char*>(memory));
+    return buffer;
+}
+
+/**
+ * @brief Closes a file descriptor when it goes out of scope
+ */
+class ScopedFd {
+public:
+    explicit ScopedFd(int fd) : fd_(fd) {}
+    ~ScopedFd() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    ScopedFd(const ScopedFd&) = delete;
+    ScopedFd& operator=(const ScopedFd&) = delete;
+
+private:
+    int fd_;
+};
+
+static bool openSessionFile(const std::string& path, int& fd, size_t& size, std::string& error) {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+// MARK: - io_uring
+
+#ifdef TENNIS_HAVE_IO_URING
+
+/**
+ * @brief Minimal io_uring wrapper on raw system calls (no liburing)
+ */
+struct FileIngestor::Ring {
+    int fd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned pendingSubmissions = 0;
+    bool registeredBuffers = false;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            return false;
+        }
+        cqRing = singleMmap ? sqRing
+                            : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        unsigned char* sq = static_cast<unsigned char*>(sqRing);
+        unsigned char* cq = static_cast<unsigned char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    bool registerBuffers(const std::vector<iovec>& iovecs) {
+        registeredBuffers = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS,
+                                    iovecs.data(), static_cast<unsigned>(iovecs.size())) == 0;
+        return registeredBuffers;
+    }
+
+    /**
+     * @brief Queue a read into `target` (registered buffer `bufferIndex`) at `offset`
+     */
+    void queueRead(int fileFd, const iovec& target, unsigned bufferIndex, uint64_t offset, uint64_t userData) {
+        const unsigned tail = *sqTail;
+        const unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = fileFd;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        if (registeredBuffers) {
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<uint64_t>(target.iov_base);
+            sqe.len = static_cast<uint32_t>(target.iov_len);
+            sqe.buf_index = static_cast<uint16_t>(bufferIndex);
+        } else {
+            sqe.opcode = IORING_OP_READV;
+            sqe.addr = reinterpret_cast<uint64_t>(&target);
+            sqe.len = 1;
+        }
+        sqArray[index] = index;
+        // The kernel reads the entry once it observes the new tail
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++pendingSubmissions;
+    }
+
+    /**
+     * @brief Submit queued reads and optionally wait for one completion
+     */
+    bool submitAndWait(unsigned waitFor) {
+        while (true) {
+            long result = syscall(__NR_io_uring_enter, fd, pendingSubmissions, waitFor,
+                                  waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (result >= 0) {
+                pendingSubmissions -= static_cast<unsigned>(result);
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    bool nextCompletion(io_uring_cqe& completion) {
+        const unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        completion = cqes[head & *cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+
+#else
+
+struct FileIngestor::Ring {};
+
+#endif // TENNIS_HAVE_IO_URING
+
+// MARK: - FileIngestor
+
+FileIngestor::FileIngestor(FileIngestConfig config) : config_(config) {
+    if (config_.queueDepth == 0) {
+        config_.queueDepth = 1;
+    }
+    // Round up so a buffer always holds whole pages
+    config_.bufferSize = (config_.bufferSize + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+
+#ifdef TENNIS_HAVE_IO_URING
+    if (config_.preferIoUring) {
+        auto ring = std::make_unique<Ring>();
+        if (ring->setup(static_cast<unsigned>(config_.queueDepth))) {
+            ring_ = std::move(ring);
+        }
+    }
+#endif
+
+    const size_t bufferCount = ring_ ? config_.queueDepth : 1;
+    for (size_t i = 0; i < bufferCount; ++i) {
+        buffers_.push_back(allocateBuffer(config_.bufferSize));
+    }
+
+#ifdef TENNIS_HAVE_IO_URING
+    if (ring_) {
+        std::vector<iovec> iovecs;
+        for (AlignedBuffer& buffer : buffers_) {
+            iovecs.push_back({buffer.data.get(), config_.bufferSize});
+        }
+        ring_->registerBuffers(iovecs);
+    }
+#endif
+}
+
+FileIngestor::~FileIngestor() = default;
+
+bool FileIngestor::usingIoUring() const {
+    return ring_ != nullptr;
+}
+
+FileIngestStats FileIngestor::ingest(
+    const std::vector<std::string>& paths,
+    const SessionHandler& onSession,
+    const ErrorHandler& onError
+) {
+    FileIngestStats stats;
+    if (ring_) {
+        ingestWithIoUring(paths, onSession, onError, stats);
+    } else {
+        ingestWithPread(paths, onSession, onError, stats);
+    }
+    return stats;
+}
+
+bool FileIngestor::readWholeFile(
+    int fd,
+    size_t size,
+    const std::string& path,
+    const SessionHandler& onSession,
+    const ErrorHandler& onError,
+    FileIngestStats& stats
+) {
+    unsigned char* target;
+    if (size <= config_.bufferSize) {
+        target = buffers_[0].data.get();
+    } else {
+        oversized_.resize((size + sizeof(double) - 1) / sizeof(double));
+        target = reinterpret_cast<unsigned char*>(oversized_.data());
+    }
+
+    const uint64_t readStartNs = tracingActive() ? traceNow() : 0;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(fd, target + done, size - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ++stats.failures;
+            if (onError) {
+                onError(path, n < 0 ? std::strerror(errno) : "Unexpected end of file");
+            }
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    stats.bytesRead += size;
+    if (readStartNs != 0) {
+        recordTraceEvent("ingest_read", readStartNs, traceNow(), TRACE_NO_SESSION, 0, "bytes", size);
+    }
+
+    SessionFileView view;
+    if (const char* error = decodeSessionFile(target, size, view)) {
+        ++stats.failures;
+        if (onError) {
+            onError(path, error);
+        }
+        return false;
+    }
+    ++stats.filesRead;
+    TENNIS_TRACE_SCOPE("ingest_session", view.sessionId, static_cast<uint32_t>(view.setCount));
+    onSession(path, view);
+    return true;
+}
+
+void FileIngestor::ingestWithPread(
+    const std::vector<std::string>& paths,
+    const SessionHandler& onSession,
+    const ErrorHandler& onError,
+    FileIngestStats& stats
+) {
+    std::string error;
+    for (const std::string& path : paths) {
+        int fd;
+        size_t size;
+        if (!openSessionFile(path, fd, size, error)) {
+            ++stats.failures;
+            if (onError) {
+                onError(path, error);
+            }
+            continue;
+        }
+        ScopedFd file(fd); // Closed even when onSession throws
+        readWholeFile(fd, size, path, onSession, onError, stats);
+    }
+}
+
+#ifdef TENNIS_HAVE_IO_URING
+
+void FileIngestor::ingestWithIoUring(
+    const std::vector<std::string>& paths,
+    const SessionHandler& onSession,
+    const ErrorHandler& onError,
+    FileIngestStats& stats
+) {
+    struct Slot {
+        int fd = -1;
+        size_t pathIndex = 0;
+        size_t size = 0;
+        size_t done = 0;
+        bool reading = false; // A read is queued or in flight
+        iovec target{};
+    };
+
+    stats.usedIoUring = true;
+    stats.usedRegisteredBuffers = ring_->registeredBuffers;
+
+    // Slot tables live on the thread's scratch arena for this call only
+    ScratchArena& arena = threadScratchArena();
+    ScratchArena::Scope scratch(arena);
+    std::pmr::vector<Slot> slots(buffers_.size(), &arena);
+    std::pmr::vector<size_t> freeSlots(&arena);
+    freeSlots.reserve(slots.size());
+    for (size_t i = slots.size(); i > 0; --i) {
+        freeSlots.push_back(i - 1);
+    }
+
+    // Runs on every exit. When onSession or the ring throws, reads may still
+    // be in flight into the slot buffers with their files open; wait for
+    // them so the next ingest() starts from an idle ring. A ring that cannot
+    // be waited on is dropped and later calls use pread.
+    struct Drain {
+        FileIngestor& ingestor;
+        std::pmr::vector<Slot>& slots;
+
+        ~Drain() {
+            size_t reading = static_cast<size_t>(
+                std::count_if(slots.begin(), slots.end(), [](const Slot& slot) { return slot.reading; }));
+            while (reading > 0) {
+                if (!ingestor.ring_->submitAndWait(1)) {
+                    ingestor.ring_.reset();
+                    break;
+                }
+                io_uring_cqe completion;
+                while (ingestor.ring_->nextCompletion(completion)) {
+                    slots[static_cast<size_t>(completion.user_data)].reading = false;
+                    --reading;
+                }
+            }
+            for (Slot& slot : slots) {
+                if (slot.fd >= 0) {
+                    ::close(slot.fd);
+                    slot.fd = -1;
+                }
+            }
+        }
+    } drain{*this, slots};
+
+    auto fail = [&](size_t pathIndex, const std::string& message) {
+        ++stats.failures;
+        if (onError) {
+            onError(paths[pathIndex], message);
+        }
+    };
+
+    auto queueRemainder = [&](size_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        slot.target.iov_base = buffers_[slotIndex].data.get() + slot.done;
+        slot.target.iov_len = slot.size - slot.done;
+        ring_->queueRead(slot.fd, slot.target, static_cast<unsigned>(slotIndex), slot.done, slotIndex);
+        slot.reading = true;
+    };
+
+    size_t nextPath = 0;
+    size_t inFlight = 0;
+    std::string error;
+
+    while (nextPath < paths.size() || inFlight > 0) {
+        // Keep every free slot busy
+        while (nextPath < paths.size() && !freeSlots.empty()) {
+            const size_t pathIndex = nextPath++;
+            int fd;
+            size_t size;
+            if (!openSessionFile(paths[pathIndex], fd, size, error)) {
+                fail(pathIndex, error);
+                continue;
+            }
+            if (size == 0 || size > config_.bufferSize) {
+                // Empty files fail decoding; oversized ones take the synchronous path
+                ScopedFd file(fd);
+                readWholeFile(fd, size, paths[pathIndex], onSession, onError, stats);
+                continue;
+            }
+
+            const size_t slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+            slots[slotIndex] = Slot{fd, pathIndex, size, 0, false, {}};
+            queueRemainder(slotIndex);
+            ++inFlight;
+        }
+
+        if (inFlight == 0) {
+            continue;
+        }
+        {
+            TENNIS_TRACE_SCOPE("ingest_wait");
+            if (!ring_->submitAndWait(1)) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+
+        io_uring_cqe completion;
+        while (ring_->nextCompletion(completion)) {
+            const size_t slotIndex = static_cast<size_t>(completion.user_data);
+            Slot& slot = slots[slotIndex];
+            slot.reading = false;
+
+            if (completion.res > 0) {
+                slot.done += static_cast<size_t>(completion.res);
+                stats.bytesRead += static_cast<size_t>(completion.res);
+                if (slot.done < slot.size) {
+                    queueRemainder(slotIndex); // Short read: fetch the rest
+                    continue;
+                }
+
+                SessionFileView view;
+                if (const char* decodeError = decodeSessionFile(buffers_[slotIndex].data.get(), slot.size, view)) {
+                    fail(slot.pathIndex, decodeError);
+                } else {
+                    ++stats.filesRead;
+                    TENNIS_TRACE_SCOPE("ingest_session", view.sessionId, static_cast<uint32_t>(view.setCount));
+                    onSession(paths[slot.pathIndex], view);
+                }
+            } else {
+                fail(slot.pathIndex, completion.res < 0 ? std::strerror(-completion.res) : "Unexpected end of file");
+            }
+
+            ::close(slot.fd);
+            slot.fd = -1;
+            freeSlots.push_back(slotIndex);
+            --inFlight;
+        }
+    }
+}
+
+#else
+
+void FileIngestor::ingestWithIoUring(
+    const std::vector<std::string>& paths,
+    const SessionHandler& onSession,
+    const ErrorHandler& onError,
+    FileIngestStats& stats
+) {
+    ingestWithPread(paths, onSession, onError, stats);
+}
+
+#endif // TENNIS_HAVE_IO_URING
+
+} // namespace tennis
@@ -0,0 +1,214 @@
+//
+//  json_reader.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the minimal JSON pull parser
+//
+
+#include "json_reader.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace tennis {
+
+// Longest numeric token accepted; longer tokens are rejected rather than truncated
+constexpr size_t MAX_NUMBER_LENGTH = 63;
+
+static bool isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+JsonReader::JsonReader(const char* data, size_t size)
+    : pos_(data), end_(data + size), depth_(0), failed_(false), first_{} {}
+
+void JsonReader::skipWhitespace() {
+    while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+        ++pos_;
+    }
+}
+
+bool JsonReader::fail() {
+    failed_ = true;
+    return false;
+}
+
+bool JsonReader::consume(char c) {
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == c) {
+        ++pos_;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::consumeLiteral(const char* literal, size_t length) {
+    if (static_cast<size_t>(end_ - pos_) < length || std::memcmp(pos_, literal, length) != 0) {
+        return fail();
+    }
+    pos_ += length;
+    return true;
+}
+
+bool JsonReader::beginObject() {
+    if (failed_ || depth_ >= MAX_DEPTH || !consume('{')) {
+        return fail();
+    }
+    first_[depth_++] = true;
+    return true;
+}
+
+bool JsonReader::beginArray() {
+    if (failed_ || depth_ >= MAX_DEPTH || !consume('[')) {
+        return fail();
+    }
+    first_[depth_++] = true;
+    return true;
+}
+
+bool JsonReader::advanceInContainer(char close) {
+    if (failed_ || depth_ == 0) {
+        return fail();
+    }
+    if (consume(close)) {
+        --depth_;
+        return false;
+    }
+    if (!first_[depth_ - 1] && !consume(',')) {
+        return fail();
+    }
+    first_[depth_ - 1] = false;
+    return true;
+}
+
+bool JsonReader::nextMember(std::string_view& key) {
+    if (!advanceInContainer('}')) {
+        return false;
+    }
+    if (!readString(key) || !consume(':')) {
+        return fail();
+    }
+    return true;
+}
+
+bool JsonReader::nextElement() {
+    return advanceInContainer(']');
+}
+
+bool JsonReader::readNumber(double& value) {
+    if (failed_) {
+        return false;
+    }
+    skipWhitespace();
+
+    const char* start = pos_;
+    while (pos_ < end_ && isNumberChar(*pos_)) {
+        ++pos_;
+    }
+    const size_t length = static_cast<size_t>(pos_ - start);
+    if (length == 0 || length > MAX_NUMBER_LENGTH) {
+        return fail();
+    }
+
+    // strtod needs a terminated string and the body buffer is not terminated
+    char token[MAX_NUMBER_LENGTH + 1];
+    std::memcpy(token, start, length);
+    token[length] = '\0';
+
+    char* parsedEnd = nullptr;
+    value = std::strtod(token, &parsedEnd);
+    if (parsedEnd != token + length) {
+        return fail();
+    }
+    return true;
+}
+
+bool JsonReader::readString(std::string_view& value) {
+    if (failed_ || !consume('"')) {
+        return fail();
+    }
+    const char* start = pos_;
+    while (pos_ < end_ && *pos_ != '"') {
+        if (*pos_ == '\\') {
+            ++pos_;
+        }
+        ++pos_;
+    }
+    if (pos_ >= end_) {
+        return fail();
+    }
+    value = std::string_view(start, static_cast<size_t>(pos_ - start));
+    ++pos_;
+    return true;
+}
+
+bool JsonReader::readBool(bool& value) {
+    if (failed_) {
+        return false;
+    }
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == 't') {
+        value = true;
+        return consumeLiteral("true", 4);
+    }
+    value = false;
+    return consumeLiteral("false", 5);
+}
+
+bool JsonReader::peekNull() {
+    skipWhitespace();
+    return !failed_ && static_cast<size_t>(end_ - pos_) >= 4 && std::memcmp(pos_, "null", 4) == 0;
+}
+
+bool JsonReader::skipValue() {
+    if (failed_) {
+        return false;
+    }
+    skipWhitespace();
+    if (pos_ >= end_) {
+        return fail();
+    }
+
+    std::string_view ignoredString;
+    double ignoredNumber;
+    bool ignoredBool;
+    switch (*pos_) {
+        case '{': {
+            std::string_view key;
+            if (!beginObject()) {
+                return false;
+            }
+            while (nextMember(key)) {
+                if (!skipValue()) {
+                    return false;
+                }
+            }
+            return !failed_;
+        }
+        case '[':
+            if (!beginArray()) {
+                return false;
+            }
+            while (nextElement()) {
+                if (!skipValue()) {
+                    return false;
+                }
+            }
+            return !failed_;
+        case '"':
+            return readString(ignoredString);
+        case 't':
+        case 'f':
+            return readBool(ignoredBool);
+        case 'n':
+            return consumeLiteral("null", 4);
+        default:
+            return readNumber(ignoredNumber);
+    }
+}
+
+bool JsonReader::finish() {
+    skipWhitespace();
+    return !failed_ && depth_ == 0 && pos_ == end_;
+}
+
+} // namespace tennis
@@ -0,0 +1,310 @@
+//
+//  kernel_dispatch.cpp
+//  Tennis Training Session Analyzer
+//
+//  Scanning and packing kernels compiled once per instruction set, plus the
+//  runtime selection between them
+//
+
+#include "kernel_dispatch.hpp"
+#include "packed_result.hpp"
+#include "scan_kernels.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// x86-64 only: the AVX2 packing moves the 8-byte totalSets with 64-bit
+// loads and stores, which would overrun a 4-byte size_t on 32-bit x86
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TENNIS_KERNELS_X86 1
+#include <cstddef>
+#include <immintrin.h>
+#else
+#define TENNIS_KERNELS_X86 0
+#endif
+
+namespace tennis {
+
+namespace {
+
+// Baseline: whatever the library is compiled for (SSE2 on x86-64)
+size_t findDurationOutOfRangeGeneric(const double* durations, size_t count, double min, double max) {
+    return scan::findDurationOutOfRange(durations, count, min, max);
+}
+
+size_t findIntensityOutOfRangeGeneric(const uint8_t* intensities, size_t count, uint8_t min, uint8_t max) {
+    return scan::findIntensityOutOfRange(intensities, count, min, max);
+}
+
+uint64_t sumIntensitiesGeneric(const uint8_t* intensities, size_t count) {
+    return scan::sumIntensities(intensities, count);
+}
+
+void packResultsGeneric(const AnalysisResult* results, size_t count, PackedAnalysisResult* packed) {
+    for (size_t i = 0; i < count; ++i) {
+        packed[i] = packResult(results[i]);
+    }
+}
+
+void unpackResultsGeneric(const PackedAnalysisResult* packed, size_t count, AnalysisResult* results) {
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = unpackResult(packed[i]);
+    }
+}
+
+const KernelTable GENERIC_KERNELS = {
+    "generic",
+    findDurationOutOfRangeGeneric,
+    findIntensityOutOfRangeGeneric,
+    sumIntensitiesGeneric,
+    packResultsGeneric,
+    unpackResultsGeneric,
+};
+
+#if TENNIS_KERNELS_X86
+
+__attribute__((target("avx2")))
+size_t findDurationOutOfRangeAvx2(const double* durations, size_t count, double min, double max) {
+    return scan::findDurationOutOfRange(durations, count, min, max);
+}
+
+__attribute__((target("avx2")))
+size_t findIntensityOutOfRangeAvx2(const uint8_t* intensities, size_t count, uint8_t min, uint8_t max) {
+    return scan::findIntensityOutOfRange(intensities, count, min, max);
+}
+
+__attribute__((target("avx2")))
+uint64_t sumIntensitiesAvx2(const uint8_t* intensities, size_t count) {
+    return scan::sumIntensities(intensities, count);
+}
+
+// Result packing, four records at a time. Each step is the vector form of
+// the scalar coder in packed_result.hpp with the same operations in the
+// same order, so the bytes match packResult() exactly: MAXPD/MINPD return
+// their second operand for NaN, as the scalar selects do, and F16C rounds
+// to nearest even and keeps NaN payloads, as floatToHalf() does. The table
+// needs F16C next to AVX2, which every AVX2 CPU has.
+#define TENNIS_TARGET_AVX2_F16C __attribute__((target("avx2,f16c")))
+
+// The transposes treat a result as two rows of four 8-byte fields: the four
+// doubles from totalActiveTime, then averageIntensity, totalWorkVolume and
+// totalSets. Reordering or resizing a field must fail here, not repack silently.
+static_assert(sizeof(size_t) == 8, "AVX2 packing needs an 8-byte size_t");
+static_assert(sizeof(AnalysisResult) == 56, "AnalysisResult must be seven 8-byte fields");
+static_assert(offsetof(AnalysisResult, totalActiveTime) == 0, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, workRestRatio) == 8, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, consistencyScore) == 16, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, trainingDensityScore) == 24, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, averageIntensity) == 32, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, totalWorkVolume) == 40, "AnalysisResult layout changed");
+static_assert(offsetof(AnalysisResult, totalSets) == 48, "AnalysisResult layout changed");
+
+// A packed record is one 16-byte row (active time, work volume, sets, both
+// scores) followed by the intensity and ratio halves as one 32-bit word
+static_assert(offsetof(PackedAnalysisResult, totalActiveTime) == 0, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, totalWorkVolume) == 4, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, totalSets) == 8, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, consistencyScore) == 12, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, trainingDensityScore) == 14, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, averageIntensity) == 16, "PackedAnalysisResult layout changed");
+static_assert(offsetof(PackedAnalysisResult, workRestRatio) == 18, "PackedAnalysisResult layout changed");
+
+// Rows a..d become columns: lane k of the result i is element i of row k
+TENNIS_TARGET_AVX2_F16C
+inline void transpose4(__m256d& a, __m256d& b, __m256d& c, __m256d& d) {
+    const __m256d ab02 = _mm256_unpacklo_pd(a, b);
+    const __m256d ab13 = _mm256_unpackhi_pd(a, b);
+    const __m256d cd02 = _mm256_unpacklo_pd(c, d);
+    const __m256d cd13 = _mm256_unpackhi_pd(c, d);
+    a = _mm256_permute2f128_pd(ab02, cd02, 0x20);
+    b = _mm256_permute2f128_pd(ab13, cd13, 0x20);
+    c = _mm256_permute2f128_pd(ab02, cd02, 0x31);
+    d = _mm256_permute2f128_pd(ab13, cd13, 0x31);
+}
+
+// The low 32 bits of each 64-bit lane
+TENNIS_TARGET_AVX2_F16C
+inline __m128i low32(__m256i values) {
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+}
+
+// clamp(values, 0, max) * steps + 0.5, truncated: packing::encodeScore and encodeIntensity
+TENNIS_TARGET_AVX2_F16C
+inline __m128i encodeFixed(__m256d values, double max, double steps) {
+    const __m256d clamped = _mm256_min_pd(_mm256_max_pd(values, _mm256_setzero_pd()), _mm256_set1_pd(max));
+    return _mm256_cvttpd_epi32(_mm256_add_pd(_mm256_mul_pd(clamped, _mm256_set1_pd(steps)), _mm256_set1_pd(0.5)));
+}
+
+// The last 24 bytes of a result (intensity, work volume, set count) as a row
+TENNIS_TARGET_AVX2_F16C
+inline __m256d loadTail(const AnalysisResult& result) {
+    const __m128d head = _mm_loadu_pd(&result.averageIntensity);
+    const __m128i sets = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&result.totalSets));
+    return _mm256_insertf128_pd(_mm256_castpd128_pd256(head), _mm_castsi128_pd(sets), 1);
+}
+
+TENNIS_TARGET_AVX2_F16C
+void packResultsAvx2(const AnalysisResult* results, size_t count, PackedAnalysisResult* packed) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Loaded one record per register, transposed to one field per register
+        const AnalysisResult* r = results + i;
+        __m256d activeTime = _mm256_loadu_pd(&r[0].totalActiveTime);
+        __m256d ratio = _mm256_loadu_pd(&r[1].totalActiveTime);
+        __m256d consistency = _mm256_loadu_pd(&r[2].totalActiveTime);
+        __m256d density = _mm256_loadu_pd(&r[3].totalActiveTime);
+        transpose4(activeTime, ratio, consistency, density);
+        __m256d intensity = loadTail(r[0]);
+        __m256d workVolume = loadTail(r[1]);
+        __m256d sets = loadTail(r[2]);
+        __m256d unused = loadTail(r[3]);
+        transpose4(intensity, workVolume, sets, unused);
+
+        // Set counts saturate at 2^32 - 1
+        const __m256i setBits = _mm256_castpd_si256(sets);
+        const __m256i fits = _mm256_cmpeq_epi64(_mm256_srli_epi64(setBits, 32), _mm256_setzero_si256());
+        const __m128i setsOut = low32(_mm256_or_si256(setBits, _mm256_xor_si256(fits, _mm256_set1_epi32(-1))));
+
+        const __m128i scores = _mm_or_si128(
+            encodeFixed(consistency, 1.0, packing::SCORE_STEPS),
+            _mm_slli_epi32(encodeFixed(density, 1.0, packing::SCORE_STEPS), 16));
+
+        const __m128i isNan = low32(_mm256_castpd_si256(_mm256_cmp_pd(intensity, intensity, _CMP_UNORD_Q)));
+        const __m128i level = _mm_blendv_epi8(
+            encodeFixed(intensity, packing::MAX_INTENSITY, packing::INTENSITY_STEPS_PER_LEVEL),
+            _mm_set1_epi32(packing::INTENSITY_NAN), isNan);
+        const __m128i half = _mm_cvtps_ph(_mm256_cvtpd_ps(ratio), _MM_FROUND_TO_NEAREST_INT);
+        const __m128i tail = _mm_or_si128(level, _mm_slli_epi32(_mm_cvtepu16_epi32(half), 16));
+
+        // Rows of (active time, work volume, sets, scores): the first 16 bytes of each record
+        __m128 row0 = _mm256_cvtpd_ps(activeTime);
+        __m128 row1 = _mm256_cvtpd_ps(workVolume);
+        __m128 row2 = _mm_castsi128_ps(setsOut);
+        __m128 row3 = _mm_castsi128_ps(scores);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        PackedAnalysisResult* p = packed + i;
+        _mm_storeu_ps(&p[0].totalActiveTime, row0);
+        _mm_storeu_ps(&p[1].totalActiveTime, row1);
+        _mm_storeu_ps(&p[2].totalActiveTime, row2);
+        _mm_storeu_ps(&p[3].totalActiveTime, row3);
+        const uint32_t tails[4] = {
+            static_cast<uint32_t>(_mm_extract_epi32(tail, 0)), static_cast<uint32_t>(_mm_extract_epi32(tail, 1)),
+            static_cast<uint32_t>(_mm_extract_epi32(tail, 2)), static_cast<uint32_t>(_mm_extract_epi32(tail, 3))};
+        for (size_t k = 0; k < 4; ++k) {
+            std::memcpy(&p[k].averageIntensity, &tails[k], sizeof(uint32_t));
+        }
+    }
+    for (; i < count; ++i) {
+        packed[i] = packResult(results[i]);
+    }
+}
+
+TENNIS_TARGET_AVX2_F16C
+void unpackResultsAvx2(const PackedAnalysisResult* packed, size_t count, AnalysisResult* results) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Loaded one record per register, transposed to one field per register
+        const PackedAnalysisResult* p = packed + i;
+        __m128 activeTime = _mm_loadu_ps(&p[0].totalActiveTime);
+        __m128 workVolume = _mm_loadu_ps(&p[1].totalActiveTime);
+        __m128 setsIn = _mm_loadu_ps(&p[2].totalActiveTime);
+        __m128 scoresIn = _mm_loadu_ps(&p[3].totalActiveTime);
+        _MM_TRANSPOSE4_PS(activeTime, workVolume, setsIn, scoresIn);
+        uint32_t tails[4];
+        for (size_t k = 0; k < 4; ++k) {
+            std::memcpy(&tails[k], &p[k].averageIntensity, sizeof(uint32_t));
+        }
+        const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tails));
+        const __m128i scores = _mm_castps_si128(scoresIn);
+        const __m128i lowHalves = _mm_set1_epi32(0xFFFF);
+
+        const __m256d scoreSteps = _mm256_set1_pd(packing::SCORE_STEPS);
+        __m256d consistency = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_and_si128(scores, lowHalves)), scoreSteps);
+        __m256d density = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_srli_epi32(scores, 16)), scoreSteps);
+
+        const __m128i level = _mm_and_si128(tail, lowHalves);
+        const __m256d isNan = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpeq_epi32(level, lowHalves)));
+        __m256d intensity = _mm256_blendv_pd(
+            _mm256_div_pd(_mm256_cvtepi32_pd(level), _mm256_set1_pd(packing::INTENSITY_STEPS_PER_LEVEL)),
+            _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN()), isNan);
+        const __m128i halves = _mm_srli_epi32(tail, 16);
+        __m256d ratio = _mm256_cvtps_pd(_mm_cvtph_ps(_mm_packus_epi32(halves, halves)));
+
+        // Back to one record per register: the first 32 bytes, then the last 24
+        __m256d active = _mm256_cvtps_pd(activeTime);
+        transpose4(active, ratio, consistency, density);
+        AnalysisResult* r = results + i;
+        _mm256_storeu_pd(&r[0].totalActiveTime, active);
+        _mm256_storeu_pd(&r[1].totalActiveTime, ratio);
+        _mm256_storeu_pd(&r[2].totalActiveTime, consistency);
+        _mm256_storeu_pd(&r[3].totalActiveTime, density);
+
+        __m256d work = _mm256_cvtps_pd(workVolume);
+        __m256d sets = _mm256_castsi256_pd(_mm256_cvtepu32_epi64(_mm_castps_si128(setsIn)));
+        __m256d unused = _mm256_setzero_pd();
+        transpose4(intensity, work, sets, unused);
+        const __m256d rows[4] = {intensity, work, sets, unused};
+        for (size_t k = 0; k < 4; ++k) {
+            _mm_storeu_pd(&r[k].averageIntensity, _mm256_castpd256_pd128(rows[k]));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&r[k].totalSets),
+                             _mm_castpd_si128(_mm256_extractf128_pd(rows[k], 1)));
+        }
+    }
+    for (; i < count; ++i) {
+        results[i] = unpackResult(packed[i]);
+    }
+}
+
+const KernelTable AVX2_KERNELS = {
+    "avx2",
+    findDurationOutOfRangeAvx2,
+    findIntensityOutOfRangeAvx2,
+    sumIntensitiesAvx2,
+    packResultsAvx2,
+    unpackResultsAvx2,
+};
+
+#endif // TENNIS_KERNELS_X86
+
+const KernelTable* selectKernels() {
+    const std::vector<const KernelTable*> supported = supportedKernelTables();
+    if (const char* requested = std::getenv("TENNIS_ANALYZER_ISA")) {
+        for (const KernelTable* table : supported) {
+            if (std::strcmp(table->isa, requested) == 0) {
+                return table;
+            }
+        }
+    }
+    return supported.back();
+}
+
+} // namespace
+
+std::vector<const KernelTable*> supportedKernelTables() {
+    std::vector<const KernelTable*> tables{&GENERIC_KERNELS};
+#if TENNIS_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")) {
+        tables.push_back(&AVX2_KERNELS);
+    }
+#endif
+    return tables;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable* const selected = selectKernels();
+    return *selected;
+}
+
+void packResults(const AnalysisResult* results, size_t count, PackedAnalysisResult* packed) {
+    kernels().packResults(results, count, packed);
+}
+
+void unpackResults(const PackedAnalysisResult* packed, size_t count, AnalysisResult* results) {
+    kernels().unpackResults(packed, count, results);
+}
+
+// Select while the library loads, so the first analysis does not pay for it
+[[maybe_unused]] static const KernelTable& loadTimeKernels = kernels();
+
+} // namespace tennis
@@ -0,0 +1,281 @@
+//
+//  latency_histogram.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the per-thread latency histograms
+//
+
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace tennis {
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Validate: return "validate";
+        case LatencyStage::TotalActiveTime: return "total_active_time";
+        case LatencyStage::WorkRestRatio: return "work_rest_ratio";
+        case LatencyStage::ConsistencyScore: return "consistency_score";
+        case LatencyStage::TrainingDensityScore: return "training_density_score";
+        case LatencyStage::Analyze: return "analyze";
+        case LatencyStage::AnalyzeBatch: return "analyze_batch";
+        case LatencyStage::ServiceQueueWait: return "service_queue_wait";
+        case LatencyStage::ServiceExecute: return "service_execute";
+        case LatencyStage::ShmAnalyze: return "shm_analyze";
+    }
+    return "unknown";
+}
+
+// MARK: - LatencyHistogram
+
+static unsigned highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < SUB_BUCKETS) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    const unsigned exponent = highestBit(nanoseconds);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    // The top SUB_BUCKET_BITS + 1 bits select the bucket within the group
+    const size_t group = exponent - SUB_BUCKET_BITS + 1;
+    const size_t offset = static_cast<size_t>(nanoseconds >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return group * SUB_BUCKETS + offset;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const size_t group = index / SUB_BUCKETS;
+    const size_t offset = index % SUB_BUCKETS;
+    return static_cast<uint64_t>(SUB_BUCKETS + offset) << (group - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index + 1;
+    }
+    return bucketLowerBound(index) + (uint64_t(1) << (index / SUB_BUCKETS - 1));
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(BUCKET_COUNT, 0), total_(0), sum_(0),
+      min_(std::numeric_limits<uint64_t>::max()), max_(0) {}
+
+void LatencyHistogram::record(uint64_t nanoseconds, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    counts_[bucketIndex(nanoseconds)] += count;
+    total_ += count;
+    sum_ += nanoseconds * count;
+    min_ = std::min(min_, nanoseconds);
+    max_ = std::max(max_, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    sum_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+}
+
+double LatencyHistogram::mean() const {
+    return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    const double clamped = std::min(100.0, std::max(0.0, percentile));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(
+        std::ceil(clamped / 100.0 * static_cast<double>(total_))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            // Highest value the bucket can hold, within the observed range
+            return std::min(max_, std::max(min_, bucketUpperBound(i) - 1));
+        }
+    }
+    return max_;
+}
+
+// MARK: - Per-thread recording
+
+/**
+ * @brief One thread's histograms
+ *
+ * Only the owning thread writes; snapshots read concurrently. Single-writer
+ * counters are updated with a relaxed load and store, which avoids locked
+ * read-modify-write instructions on the hot path.
+ */
+struct ThreadLatencyRecorder {
+    struct Stage {
+        std::atomic<uint64_t> counts[LatencyHistogram::BUCKET_COUNT];
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> min;
+        std::atomic<uint64_t> max;
+    };
+
+    ThreadLatencyRecorder() {
+        reset();
+    }
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void record(LatencyStage stage, uint64_t nanoseconds) {
+        Stage& s = stages[static_cast<size_t>(stage)];
+        bump(s.counts[LatencyHistogram::bucketIndex(nanoseconds)], 1);
+        bump(s.total, 1);
+        bump(s.sum, nanoseconds);
+        if (nanoseconds < s.min.load(std::memory_order_relaxed)) {
+            s.min.store(nanoseconds, std::memory_order_relaxed);
+        }
+        if (nanoseconds > s.max.load(std::memory_order_relaxed)) {
+            s.max.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    void addTo(LatencySnapshot& snapshot) const {
+        for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            const Stage& s = stages[i];
+            LatencyHistogram& h = snapshot[static_cast<LatencyStage>(i)];
+            for (size_t b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b) {
+                h.counts_[b] += s.counts[b].load(std::memory_order_relaxed);
+            }
+            h.total_ += s.total.load(std::memory_order_relaxed);
+            h.sum_ += s.sum.load(std::memory_order_relaxed);
+            h.min_ = std::min(h.min_, s.min.load(std::memory_order_relaxed));
+            h.max_ = std::max(h.max_, s.max.load(std::memory_order_relaxed));
+        }
+    }
+
+    void reset() {
+        for (Stage& s : stages) {
+            for (std::atomic<uint64_t>& count : s.counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+            s.total.store(0, std::memory_order_relaxed);
+            s.sum.store(0, std::memory_order_relaxed);
+            s.min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+            s.max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Stage stages[LATENCY_STAGE_COUNT];
+};
+
+namespace {
+
+/**
+ * @brief Live recorders plus the merged totals of threads that have exited
+ */
+struct LatencyRegistry {
+    std::mutex mutex;
+    std::vector<ThreadLatencyRecorder*> live;
+    LatencySnapshot retired;
+};
+
+LatencyRegistry& registry() {
+    // Leaked so thread exit during static destruction can still unregister
+    static LatencyRegistry* instance = new LatencyRegistry();
+    return *instance;
+}
+
+/**
+ * @brief Registers the thread's recorder on first use, folds it into the
+ * retired totals when the thread exits
+ */
+class RecorderHandle {
+public:
+    RecorderHandle() : recorder_(new ThreadLatencyRecorder()) {
+        LatencyRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(recorder_.get());
+    }
+
+    ~RecorderHandle() {
+        LatencyRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        recorder_->addTo(r.retired);
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), recorder_.get()), r.live.end());
+    }
+
+    ThreadLatencyRecorder& recorder() { return *recorder_; }
+
+private:
+    std::unique_ptr<ThreadLatencyRecorder> recorder_;
+};
+
+} // namespace
+
+#if TENNIS_ANALYZER_ENABLE_HISTOGRAMS
+
+void recordLatency(LatencyStage stage, uint64_t nanoseconds) {
+    thread_local RecorderHandle handle;
+    handle.recorder().record(stage, nanoseconds);
+}
+
+#endif
+
+LatencySnapshot latencySnapshot() {
+    LatencyRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    LatencySnapshot snapshot;
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        snapshot[stage].merge(r.retired[stage]);
+    }
+    for (const ThreadLatencyRecorder* recorder : r.live) {
+        recorder->addTo(snapshot);
+    }
+    return snapshot;
+}
+
+void resetLatencyHistograms() {
+    LatencyRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        r.retired[static_cast<LatencyStage>(i)].reset();
+    }
+    for (ThreadLatencyRecorder* recorder : r.live) {
+        recorder->reset();
+    }
+}
+
+} // namespace tennis
@@ -0,0 +1,314 @@
+//
+//  metrics.cpp
+//  Tennis Training Session Analyzer
+//
+//  Per-thread metric counters and Prometheus text exposition
+//
+
+#include "metrics.hpp"
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace tennis {
+
+namespace {
+
+struct CounterInfo {
+    const char* name;
+    const char* labels;
+    const char* help;
+};
+
+// Indexed by MetricCounter; counters sharing a name become one labelled family
+const CounterInfo COUNTER_INFO[METRIC_COUNTER_COUNT] = {
+    {"tennis_sessions_analyzed_total", "", "Sessions that passed validation and were analyzed"},
+    {"tennis_sets_analyzed_total", "", "Sets in analyzed sessions"},
+    {"tennis_batches_analyzed_total", "", "analyzeBatch calls"},
+    {"tennis_validation_failures_total", "reason=\"size_mismatch\"", "Sessions rejected by input validation"},
+    {"tennis_validation_failures_total", "reason=\"duration_out_of_range\"", "Sessions rejected by input validation"},
+    {"tennis_validation_failures_total", "reason=\"intensity_out_of_range\"", "Sessions rejected by input validation"},
+};
+
+// Upper bounds of the exported latency buckets, in seconds
+const double LATENCY_BUCKET_BOUNDS[] = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+    1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+};
+
+/**
+ * @brief One thread's counters, on their own cache lines
+ *
+ * Only the owning thread writes `values`, and they only grow; expositions
+ * read them concurrently. A reset must not store into `values`: the owner's
+ * load-then-store would overwrite a zero that lands between the two. It
+ * records the current values in `resetBase` instead, and readers subtract
+ * that.
+ */
+struct alignas(64) ThreadMetricCounters {
+    std::atomic<uint64_t> values[METRIC_COUNTER_COUNT] = {};
+    uint64_t resetBase[METRIC_COUNTER_COUNT] = {}; // Guarded by the registry mutex
+
+    // Count since the last reset; call with the registry mutex held
+    uint64_t sinceReset(size_t index) const {
+        return values[index].load(std::memory_order_relaxed) - resetBase[index];
+    }
+
+    // Call with the registry mutex held
+    void reset() {
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            resetBase[i] = values[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * @brief Live per-thread counters plus the totals of threads that have exited
+ */
+struct CounterRegistry {
+    std::mutex mutex;
+    std::vector<ThreadMetricCounters*> live;
+    uint64_t retired[METRIC_COUNTER_COUNT] = {};
+};
+
+CounterRegistry& counterRegistry() {
+    // Leaked so thread exit during static destruction can still unregister
+    static CounterRegistry* instance = new CounterRegistry();
+    return *instance;
+}
+
+/**
+ * @brief Registers the thread's counters on first use, folds them into the
+ * retired totals when the thread exits
+ */
+class CounterHandle {
+public:
+    CounterHandle() : counters_(new ThreadMetricCounters()) {
+        CounterRegistry& r = counterRegistry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(counters_.get());
+    }
+
+    ~CounterHandle() {
+        CounterRegistry& r = counterRegistry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            r.retired[i] += counters_->sinceReset(i);
+        }
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), counters_.get()), r.live.end());
+    }
+
+    ThreadMetricCounters& counters() { return *counters_; }
+
+private:
+    std::unique_ptr<ThreadMetricCounters> counters_;
+};
+
+void appendValue(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+    } else if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+    } else {
+        // Shortest text that reads back as the same value. Unlike printf,
+        // to_chars ignores the locale, so the decimal separator is always '.'
+        // as the exposition format requires
+        char text[32];
+        out.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+    }
+}
+
+void appendUnsigned(std::string& out, uint64_t value) {
+    char text[24];
+    std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+    out += text;
+}
+
+void appendFamilyHeader(std::string& out, const char* name, const char* help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void appendSeriesName(std::string& out, const std::string& name, const std::string& labels) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+}
+
+void writeLibraryCounters(std::string& out) {
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        const CounterInfo& info = COUNTER_INFO[i];
+        if (i == 0 || std::string(info.name) != COUNTER_INFO[i - 1].name) {
+            appendFamilyHeader(out, info.name, info.help, "counter");
+        }
+        appendSeriesName(out, info.name, info.labels);
+        appendUnsigned(out, metricCounterValue(static_cast<MetricCounter>(i)));
+        out += '\n';
+    }
+}
+
+/**
+ * @brief Re-bucket the log-linear histograms onto fixed bounds
+ *
+ * A histogram bucket counts toward a bound only if its whole range lies
+ * below the bound, so cumulative counts may lag by one bucket (about 3%).
+ */
+void writeLatencyHistograms(std::string& out) {
+    const LatencySnapshot snapshot = latencySnapshot();
+    const char* name = "tennis_stage_latency_seconds";
+    bool headerWritten = false;
+
+    for (size_t s = 0; s < LATENCY_STAGE_COUNT; ++s) {
+        const LatencyStage stage = static_cast<LatencyStage>(s);
+        const LatencyHistogram& h = snapshot[stage];
+        if (h.count() == 0) {
+            continue;
+        }
+        if (!headerWritten) {
+            appendFamilyHeader(out, name, "Latency of instrumented pipeline stages", "histogram");
+            headerWritten = true;
+        }
+
+        const std::string stageLabel = std::string("stage=\"") + latencyStageName(stage) + "\"";
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (double bound : LATENCY_BUCKET_BOUNDS) {
+            const uint64_t boundNs = static_cast<uint64_t>(std::llround(bound * 1e9));
+            while (bucket < LatencyHistogram::BUCKET_COUNT &&
+                   LatencyHistogram::bucketUpperBound(bucket) - 1 <= boundNs) {
+                cumulative += h.bucketCount(bucket);
+                ++bucket;
+            }
+            out += name;
+            out += "_bucket{" + stageLabel + ",le=\"";
+            appendValue(out, bound);
+            out += "\"} ";
+            appendUnsigned(out, cumulative);
+            out += '\n';
+        }
+        out += name;
+        out += "_bucket{" + stageLabel + ",le=\"+Inf\"} ";
+        appendUnsigned(out, h.count());
+        out += '\n';
+
+        out += name;
+        out += "_sum{" + stageLabel + "} ";
+        appendValue(out, static_cast<double>(h.sum()) / 1e9);
+        out += '\n';
+        out += name;
+        out += "_count{" + stageLabel + "} ";
+        appendUnsigned(out, h.count());
+        out += '\n';
+    }
+}
+
+} // namespace
+
+// MARK: - Library counters
+
+#if TENNIS_ANALYZER_ENABLE_METRICS
+
+void incrementMetric(MetricCounter counter, uint64_t amount) {
+    thread_local CounterHandle handle;
+    std::atomic<uint64_t>& value = handle.counters().values[static_cast<size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+#endif
+
+uint64_t metricCounterValue(MetricCounter counter) {
+    const size_t index = static_cast<size_t>(counter);
+    CounterRegistry& r = counterRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t total = r.retired[index];
+    for (const ThreadMetricCounters* counters : r.live) {
+        total += counters->sinceReset(index);
+    }
+    return total;
+}
+
+void resetMetricCounters() {
+    CounterRegistry& r = counterRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::fill(std::begin(r.retired), std::end(r.retired), 0);
+    for (ThreadMetricCounters* counters : r.live) {
+        counters->reset();
+    }
+}
+
+// MARK: - MetricsRegistry
+
+MetricsRegistry::CallbackId MetricsRegistry::addCallback(
+    MetricType type,
+    std::string name,
+    std::string help,
+    std::string labels,
+    std::function<double()> sample
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const CallbackId id = nextId_++;
+    callbacks_.push_back({id, type, std::move(name), std::move(help), std::move(labels), std::move(sample)});
+    return id;
+}
+
+void MetricsRegistry::removeCallback(CallbackId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callbacks_.erase(std::remove_if(callbacks_.begin(), callbacks_.end(),
+                                    [id](const Callback& c) { return c.id == id; }),
+                     callbacks_.end());
+}
+
+void MetricsRegistry::writePrometheus(std::string& out) const {
+    if (METRICS_ENABLED) {
+        writeLibraryCounters(out);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Series of one family must be contiguous, under a single HELP/TYPE
+        std::vector<bool> written(callbacks_.size(), false);
+        for (size_t i = 0; i < callbacks_.size(); ++i) {
+            if (written[i]) {
+                continue;
+            }
+            const Callback& family = callbacks_[i];
+            appendFamilyHeader(out, family.name.c_str(), family.help.c_str(),
+                               family.type == MetricType::Counter ? "counter" : "gauge");
+            for (size_t j = i; j < callbacks_.size(); ++j) {
+                if (!written[j] && callbacks_[j].name == family.name) {
+                    appendSeriesName(out, callbacks_[j].name, callbacks_[j].labels);
+                    appendValue(out, callbacks_[j].sample());
+                    out += '\n';
+                    written[j] = true;
+                }
+            }
+        }
+    }
+
+    if (LATENCY_HISTOGRAMS_ENABLED) {
+        writeLatencyHistograms(out);
+    }
+}
+
+MetricsRegistry& metricsRegistry() {
+    // Leaked so components destroyed during static destruction can still unregister
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+} // namespace tennis
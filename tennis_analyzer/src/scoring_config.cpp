@@ -0,0 +1,99 @@
+//
+//  scoring_config.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the RCU scoring configuration holder
+//
+
+#include "scoring_config.hpp"
+#include <thread>
+
+namespace tennis {
+
+const ScoringConfig& ScoringConfig::defaults() {
+    static const ScoringConfig instance{};
+    return instance;
+}
+
+/**
+ * @brief Stripe used by the calling thread, assigned round-robin on first use
+ */
+static size_t threadStripe(size_t stripes) {
+    static std::atomic<size_t> nextStripe{0};
+    thread_local size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed);
+    return stripe % stripes;
+}
+
+// MARK: - Snapshot
+
+ScoringConfigHolder::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : counter_(other.counter_), config_(other.config_) {
+    other.counter_ = nullptr;
+}
+
+ScoringConfigHolder::Snapshot::~Snapshot() {
+    if (counter_) {
+        counter_->fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// MARK: - ScoringConfigHolder
+
+ScoringConfigHolder::ScoringConfigHolder(const ScoringConfig& initial)
+    : current_(new ScoringConfig(initial)) {
+    for (Stripe& stripe : stripes_) {
+        stripe.readers[0].store(0, std::memory_order_relaxed);
+        stripe.readers[1].store(0, std::memory_order_relaxed);
+    }
+}
+
+ScoringConfigHolder::~ScoringConfigHolder() {
+    delete current_.load();
+}
+
+ScoringConfigHolder::Snapshot ScoringConfigHolder::snapshot() const {
+    const unsigned phase = phase_.load() & 1u;
+    std::atomic<int64_t>* counter = &stripes_[threadStripe(STRIPES)].readers[phase];
+
+    // The pointer must be loaded after the counter is raised: a publisher
+    // that sees the counter at zero has then already swapped the pointer
+    counter->fetch_add(1);
+    return Snapshot(counter, current_.load());
+}
+
+void ScoringConfigHolder::waitForReaders(unsigned phase) {
+    while (true) {
+        int64_t active = 0;
+        for (const Stripe& stripe : stripes_) {
+            active += stripe.readers[phase].load();
+        }
+        if (active == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ScoringConfigHolder::publish(const ScoringConfig& next) {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+
+    const ScoringConfig* previous = current_.exchange(new ScoringConfig(next));
+    version_.fetch_add(1, std::memory_order_relaxed);
+
+    // Grace period: flip the phase twice, each time waiting for the phase
+    // new readers no longer enter to drain. Any reader that loaded the old
+    // pointer was counted in one of the two phases.
+    for (int round = 0; round < 2; ++round) {
+        const unsigned drained = phase_.fetch_add(1) & 1u;
+        waitForReaders(drained);
+    }
+
+    delete previous;
+}
+
+ScoringConfigHolder& globalScoringConfig() {
+    static ScoringConfigHolder holder;
+    return holder;
+}
+
+} // namespace tennis
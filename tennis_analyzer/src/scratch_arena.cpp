@@ -0,0 +1,81 @@
+//
+//  scratch_arena.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the per-thread scratch arenas
+//
+
+#include "scratch_arena.hpp"
+#include <algorithm>
+
+namespace tennis {
+
+/**
+ * @brief Header in front of each block's storage
+ */
+struct alignas(alignof(std::max_align_t)) ScratchArena::Block {
+    Block* next;
+    size_t size;
+
+    unsigned char* data() { return reinterpret_cast<unsigned char*>(this + 1); }
+};
+
+ScratchArena::ScratchArena(size_t blockSize, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), nextBlockSize_(std::max<size_t>(blockSize, 256)) {}
+
+ScratchArena::~ScratchArena() {
+    Block* block = first_;
+    while (block) {
+        Block* next = block->next;
+        upstream_->deallocate(block, sizeof(Block) + block->size, alignof(Block));
+        block = next;
+    }
+}
+
+void ScratchArena::rewind(const Marker& marker) {
+    current_ = static_cast<Block*>(marker.block);
+    offset_ = marker.offset;
+    used_ = marker.used;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    // Bump through the current block, then any blocks kept from earlier batches
+    Block* block = current_ ? current_ : first_;
+    size_t offset = current_ ? offset_ : 0;
+    Block* last = nullptr;
+    while (block) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block->data());
+        const uintptr_t start = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (start + bytes <= base + block->size) {
+            const size_t end = static_cast<size_t>(start - base) + bytes;
+            used_ += end - offset;
+            current_ = block;
+            offset_ = end;
+            return reinterpret_cast<void*>(start);
+        }
+        last = block;
+        block = block->next;
+        offset = 0;
+    }
+
+    // Nothing left fits: append a block large enough for this request
+    const size_t size = std::max(nextBlockSize_, bytes + alignment);
+    Block* fresh = static_cast<Block*>(upstream_->allocate(sizeof(Block) + size, alignof(Block)));
+    fresh->next = nullptr;
+    fresh->size = size;
+    (last ? last->next : first_) = fresh;
+    capacity_ += size;
+    nextBlockSize_ = size * 2;
+    ++upstreamAllocations_;
+
+    current_ = fresh;
+    offset_ = 0;
+    return do_allocate(bytes, alignment);
+}
+
+ScratchArena& threadScratchArena() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+} // namespace tennis
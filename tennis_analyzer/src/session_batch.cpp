@@ -0,0 +1,155 @@
+//
+//  session_batch.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of columnar session batches
+//
+
+#include "session_batch.hpp"
+#include "allocation_tracker.hpp"
+#include "analysis_kernels.hpp"
+#include "latency_histogram.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <stdexcept>
+
+namespace tennis {
+
+void SessionBatch::addSession(const double* durations, const uint8_t* intensities, size_t count) {
+    durations_.insert(durations_.end(), durations, durations + count);
+    intensities_.insert(intensities_.end(), intensities, intensities + count);
+    offsets_.push_back(durations_.size());
+}
+
+void SessionBatch::addSession(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) {
+    if (durations.size() != intensities.size()) {
+        throw std::invalid_argument(
+            "Durations and intensities vectors must have the same size"
+        );
+    }
+    addSession(durations.data(), intensities.data(), durations.size());
+}
+
+void SessionBatch::reserve(size_t sessions, size_t sets) {
+    durations_.reserve(sets);
+    intensities_.reserve(sets);
+    offsets_.reserve(sessions + 1);
+}
+
+void SessionBatch::clear() {
+    durations_.clear();
+    intensities_.clear();
+    offsets_.resize(1);
+}
+
+void pmr::SessionBatch::addSession(const double* durations, const uint8_t* intensities, size_t count) {
+    durations_.insert(durations_.end(), durations, durations + count);
+    intensities_.insert(intensities_.end(), intensities, intensities + count);
+    offsets_.push_back(durations_.size());
+}
+
+void pmr::SessionBatch::addSession(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) {
+    if (durations.size() != intensities.size()) {
+        throw std::invalid_argument(
+            "Durations and intensities vectors must have the same size"
+        );
+    }
+    addSession(durations.data(), intensities.data(), durations.size());
+}
+
+void pmr::SessionBatch::reserve(size_t sessions, size_t sets) {
+    durations_.reserve(sets);
+    intensities_.reserve(sets);
+    offsets_.reserve(sessions + 1);
+}
+
+void pmr::SessionBatch::clear() {
+    durations_.clear();
+    intensities_.clear();
+    offsets_.resize(1);
+}
+
+// The analysis is shared by both batch flavours; only the containers differ
+
+template <typename Batch, typename Result>
+static void prepareResult(const Batch& batch, Result& out) {
+    const size_t sessions = batch.sessionCount();
+    out.results.assign(sessions, AnalysisResult{});
+    out.errors.resize(sessions);
+    out.failedSessions = 0;
+}
+
+template <typename Batch, typename Result>
+static size_t analyzeRange(const Batch& batch, size_t first, size_t last, Result& out) {
+    TennisAnalyzer analyzer;
+    size_t failed = 0;
+
+    for (size_t s = first; s < last; ++s) {
+        const size_t count = batch.setCount(s);
+        TENNIS_TRACE_SCOPE("batch_session", s, static_cast<uint32_t>(count));
+        out.errors[s].clear();
+        ValidationResult validation =
+            analyzer.tryAnalyze(batch.durations(s), batch.intensities(s), count, out.results[s]);
+        if (!validation.ok()) {
+            analysis::appendValidationMessage(out.errors[s], validation);
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+template <typename Batch, typename Result>
+static void analyzeAll(const Batch& batch, Result& out) {
+    TENNIS_LATENCY_SCOPE(AnalyzeBatch);
+    TENNIS_ALLOCATION_SCOPE(AnalyzeBatch);
+    TENNIS_TRACE_SCOPE("analyze_batch", TRACE_NO_SESSION, static_cast<uint32_t>(batch.totalSetCount()));
+
+    incrementMetric(MetricCounter::BatchesAnalyzed);
+
+    prepareResult(batch, out);
+    out.failedSessions = analyzeRange(batch, 0, batch.sessionCount(), out);
+}
+
+void prepareBatchResult(const SessionBatch& batch, BatchResult& out) {
+    prepareResult(batch, out);
+}
+
+size_t analyzeBatchRange(const SessionBatch& batch, size_t first, size_t last, BatchResult& out) {
+    return analyzeRange(batch, first, last, out);
+}
+
+void analyzeBatch(const SessionBatch& batch, BatchResult& out) {
+    analyzeAll(batch, out);
+}
+
+BatchResult analyzeBatch(const SessionBatch& batch) {
+    BatchResult out;
+    analyzeBatch(batch, out);
+    return out;
+}
+
+void prepareBatchResult(const pmr::SessionBatch& batch, pmr::BatchResult& out) {
+    prepareResult(batch, out);
+}
+
+size_t analyzeBatchRange(const pmr::SessionBatch& batch, size_t first, size_t last, pmr::BatchResult& out) {
+    return analyzeRange(batch, first, last, out);
+}
+
+void analyzeBatch(const pmr::SessionBatch& batch, pmr::BatchResult& out) {
+    analyzeAll(batch, out);
+}
+
+pmr::BatchResult analyzeBatch(const pmr::SessionBatch& batch) {
+    pmr::BatchResult out(batch.get_allocator());
+    analyzeBatch(batch, out);
+    return out;
+}
+
+} // namespace tennis
@@ -0,0 +1,87 @@
+//
+//  session_file.cpp
+//  Tennis Training Session Analyzer
+//
+//  Encoding and decoding of session files
+//
+
+#include "session_file.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace tennis {
+
+static_assert(sizeof(SessionFileHeader) == 24, "session file header must stay 24 bytes");
+
+size_t sessionFileSize(size_t setCount) {
+    return sizeof(SessionFileHeader) + setCount * (sizeof(double) + sizeof(uint8_t));
+}
+
+void encodeSessionFile(
+    uint64_t sessionId,
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    std::vector<char>& out
+) {
+    SessionFileHeader header{{'T', 'P', 'S', 'F'}, SESSION_FILE_VERSION, sessionId,
+                             static_cast<uint32_t>(count), 0};
+    out.resize(sessionFileSize(count));
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), durations, count * sizeof(double));
+    std::memcpy(out.data() + sizeof(header) + count * sizeof(double), intensities, count);
+}
+
+void writeSessionFile(
+    const std::string& path,
+    uint64_t sessionId,
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) {
+    if (durations.size() != intensities.size()) {
+        throw std::invalid_argument(
+            "Durations and intensities vectors must have the same size"
+        );
+    }
+
+    std::vector<char> encoded;
+    encodeSessionFile(sessionId, durations.data(), intensities.data(), durations.size(), encoded);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write session file " + path);
+    }
+}
+
+const char* decodeSessionFile(const void* data, size_t size, SessionFileView& view) {
+    if (size < sizeof(SessionFileHeader)) {
+        return "Session file is truncated";
+    }
+
+    SessionFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, "TPSF", 4) != 0) {
+        return "Not a session file";
+    }
+    if (header.version != SESSION_FILE_VERSION) {
+        return "Unsupported session file version";
+    }
+    if (size != sessionFileSize(header.setCount)) {
+        return "Session file size does not match its set count";
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(double) != 0) {
+        return "Session file buffer is not 8-byte aligned";
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    view.sessionId = header.sessionId;
+    view.setCount = header.setCount;
+    view.durations = reinterpret_cast<const double*>(bytes + sizeof(header));
+    view.intensities = reinterpret_cast<const uint8_t*>(bytes + sizeof(header) + header.setCount * sizeof(double));
+    return nullptr;
+}
+
+} // namespace tennis
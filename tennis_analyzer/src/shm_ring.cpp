@@ -0,0 +1,501 @@
+//
+//  shm_ring.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the shared-memory ring transport
+//
+
+#include "shm_ring.hpp"
+#include "allocation_tracker.hpp"
+#include "latency_histogram.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace tennis {
+
+constexpr uint32_t RING_MAGIC = 0x54505352; // "TPSR"
+constexpr uint32_t RING_VERSION = 1;
+constexpr size_t CACHE_LINE = 64;
+constexpr int SPIN_ITERATIONS = 256;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+/**
+ * @brief Control block at the start of the mapping
+ *
+ * Producer and consumer cursors live on separate cache lines. Each futex
+ * word is bumped on every state change of interest and paired with a
+ * waiter count so that the fast path never enters the kernel.
+ */
+struct ShmRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    Mode mode;
+    uint32_t reserved;
+    uint64_t slotCount;
+    uint64_t slotSize;
+    uint64_t slotStride;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> enqueuePos;
+    alignas(CACHE_LINE) std::atomic<uint64_t> dequeuePos;
+    alignas(CACHE_LINE) std::atomic<uint32_t> readableSeq;
+    std::atomic<uint32_t> readWaiters;
+    alignas(CACHE_LINE) std::atomic<uint32_t> writableSeq;
+    std::atomic<uint32_t> writeWaiters;
+};
+
+/**
+ * @brief Per-slot prefix; the payload follows at offset 16
+ */
+struct SlotHeader {
+    std::atomic<uint64_t> sequence;
+    uint64_t length;
+};
+
+static size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    // Shared (non-private) futex: the word is mapped by several processes
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    if (word.load() == expected) {
+        std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(50000)));
+    }
+#endif
+}
+
+static void futexWakeAll(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+/**
+ * @brief Wait until `ready()` holds, spinning briefly before parking
+ */
+template <typename Ready>
+static bool waitFor(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters,
+                    std::chrono::nanoseconds timeout, Ready ready) {
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        if (ready()) {
+            return true;
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        waiters.fetch_add(1);
+        const uint32_t observed = seq.load();
+        if (ready()) {
+            waiters.fetch_sub(1);
+            return true;
+        }
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            waiters.fetch_sub(1);
+            return false;
+        }
+        futexWait(seq, observed, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+        waiters.fetch_sub(1);
+    }
+}
+
+static void notifyPeers(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters) {
+    seq.fetch_add(1);
+    if (waiters.load() > 0) {
+        futexWakeAll(seq);
+    }
+}
+
+// MARK: - ShmRing
+
+ShmRing::ShmRing(const std::string& name, void* mapping, size_t mappingSize, bool owner)
+    : name_(name), mapping_(mapping), mappingSize_(mappingSize), owner_(owner),
+      header_(static_cast<Header*>(mapping)) {}
+
+ShmRing::ShmRing(ShmRing&& other) noexcept
+    : name_(std::move(other.name_)), mapping_(other.mapping_), mappingSize_(other.mappingSize_),
+      owner_(other.owner_), header_(other.header_), mode_(other.mode_), slotCount_(other.slotCount_),
+      slotSize_(other.slotSize_), slotStride_(other.slotStride_) {
+    other.mapping_ = nullptr;
+    other.header_ = nullptr;
+    other.owner_ = false;
+}
+
+ShmRing& ShmRing::operator=(ShmRing&& other) noexcept {
+    if (this != &other) {
+        release();
+        name_ = std::move(other.name_);
+        mapping_ = other.mapping_;
+        mappingSize_ = other.mappingSize_;
+        owner_ = other.owner_;
+        header_ = other.header_;
+        mode_ = other.mode_;
+        slotCount_ = other.slotCount_;
+        slotSize_ = other.slotSize_;
+        slotStride_ = other.slotStride_;
+        other.mapping_ = nullptr;
+        other.header_ = nullptr;
+        other.owner_ = false;
+    }
+    return *this;
+}
+
+ShmRing::~ShmRing() {
+    release();
+}
+
+void ShmRing::release() {
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+        mapping_ = nullptr;
+        header_ = nullptr;
+    }
+    if (owner_) {
+        shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+ShmRing ShmRing::create(const std::string& name, size_t slotCount, size_t slotSize, Mode mode) {
+    const size_t headerSize = roundUp(sizeof(Header), CACHE_LINE);
+    const size_t maxBytes = SIZE_MAX / 2;
+    if (slotCount > maxBytes || slotSize > maxBytes - sizeof(SlotHeader) - CACHE_LINE) {
+        throw std::runtime_error("Ring geometry for " + name + " is too large");
+    }
+    size_t count = 1;
+    while (count < slotCount) {
+        count <<= 1;
+    }
+    const size_t stride = roundUp(sizeof(SlotHeader) + slotSize, CACHE_LINE);
+    if (count > (maxBytes - headerSize) / stride) {
+        throw std::runtime_error("Ring geometry for " + name + " is too large");
+    }
+    const size_t totalSize = headerSize + stride * count;
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("shm_open failed for " + name + ": " + std::strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Failed to size shared memory segment " + name);
+    }
+    void* mapping = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Failed to map shared memory segment " + name);
+    }
+
+    // Fresh segments are zero-filled; construct the control block in place
+    Header* header = new (mapping) Header();
+    header->version = RING_VERSION;
+    header->mode = mode;
+    header->slotCount = count;
+    header->slotSize = stride - sizeof(SlotHeader);
+    header->slotStride = stride;
+
+    ShmRing ring(name, mapping, totalSize, true);
+    ring.mode_ = mode;
+    ring.slotCount_ = count;
+    ring.slotSize_ = stride - sizeof(SlotHeader);
+    ring.slotStride_ = stride;
+    for (uint64_t i = 0; i < count; ++i) {
+        new (ring.slot(i)) SlotHeader{{i}, 0};
+    }
+
+    // Publishing the magic last makes half-initialized rings unopenable
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RING_MAGIC;
+    return ring;
+}
+
+ShmRing ShmRing::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("shm_open failed for " + name + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("Shared memory segment " + name + " is not a ring");
+    }
+    const size_t totalSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory segment " + name);
+    }
+
+    ShmRing ring(name, mapping, totalSize, false);
+    const Header* header = ring.header_;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // The header is writable by the peer: read the geometry once, check it
+    // completely, and only ever use the checked copy
+    const uint32_t magic = header->magic;
+    const uint32_t version = header->version;
+    const Mode mode = header->mode;
+    const uint64_t count = header->slotCount;
+    const uint64_t size = header->slotSize;
+    const uint64_t stride = header->slotStride;
+    const size_t headerSize = roundUp(sizeof(Header), CACHE_LINE);
+    const bool valid =
+        magic == RING_MAGIC && version == RING_VERSION &&
+        (mode == Mode::SingleProducer || mode == Mode::MultiProducer) &&
+        count != 0 && (count & (count - 1)) == 0 &&
+        stride >= sizeof(SlotHeader) && stride % CACHE_LINE == 0 &&
+        size <= stride - sizeof(SlotHeader) &&
+        totalSize >= headerSize && stride <= totalSize - headerSize &&
+        count <= (totalSize - headerSize) / stride;
+    if (!valid) {
+        throw std::runtime_error("Shared memory segment " + name + " has an incompatible layout");
+    }
+    ring.mode_ = mode;
+    ring.slotCount_ = count;
+    ring.slotSize_ = static_cast<size_t>(size);
+    ring.slotStride_ = static_cast<size_t>(stride);
+    return ring;
+}
+
+unsigned char* ShmRing::slot(uint64_t position) const {
+    const size_t index = static_cast<size_t>(position & (slotCount_ - 1));
+    return static_cast<unsigned char*>(mapping_) + roundUp(sizeof(Header), CACHE_LINE) + index * slotStride_;
+}
+
+bool ShmRing::beginWrite(WriteTicket& ticket) {
+    uint64_t position = header_->enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        SlotHeader* s = reinterpret_cast<SlotHeader*>(slot(position));
+        const uint64_t sequence = s->sequence.load(std::memory_order_acquire);
+        const int64_t diff = static_cast<int64_t>(sequence - position);
+
+        if (diff == 0) {
+            if (mode_ == Mode::SingleProducer) {
+                header_->enqueuePos.store(position + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (header_->enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Consumer has not released this slot yet: full
+        } else {
+            position = header_->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    ticket.data = slot(position) + sizeof(SlotHeader);
+    ticket.capacity = slotSize_;
+    ticket.position = position;
+    return true;
+}
+
+void ShmRing::commitWrite(const WriteTicket& ticket, size_t length) {
+    SlotHeader* s = reinterpret_cast<SlotHeader*>(slot(ticket.position));
+    s->length = length;
+    s->sequence.store(ticket.position + 1, std::memory_order_release);
+    notifyPeers(header_->readableSeq, header_->readWaiters);
+}
+
+bool ShmRing::beginRead(ReadTicket& ticket) {
+    // Single consumer: the dequeue cursor is only advanced by this side
+    const uint64_t position = header_->dequeuePos.load(std::memory_order_relaxed);
+    SlotHeader* s = reinterpret_cast<SlotHeader*>(slot(position));
+    if (s->sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    header_->dequeuePos.store(position + 1, std::memory_order_relaxed);
+
+    ticket.data = slot(position) + sizeof(SlotHeader);
+    ticket.length = static_cast<size_t>(s->length);
+    ticket.position = position;
+    return true;
+}
+
+void ShmRing::commitRead(const ReadTicket& ticket) {
+    SlotHeader* s = reinterpret_cast<SlotHeader*>(slot(ticket.position));
+    s->sequence.store(ticket.position + slotCount_, std::memory_order_release);
+    notifyPeers(header_->writableSeq, header_->writeWaiters);
+}
+
+bool ShmRing::waitWritable(std::chrono::nanoseconds timeout) {
+    return waitFor(header_->writableSeq, header_->writeWaiters, timeout, [this] {
+        const uint64_t position = header_->enqueuePos.load(std::memory_order_relaxed);
+        const SlotHeader* s = reinterpret_cast<const SlotHeader*>(slot(position));
+        return s->sequence.load(std::memory_order_acquire) == position;
+    });
+}
+
+bool ShmRing::waitReadable(std::chrono::nanoseconds timeout) {
+    return waitFor(header_->readableSeq, header_->readWaiters, timeout, [this] {
+        const uint64_t position = header_->dequeuePos.load(std::memory_order_relaxed);
+        const SlotHeader* s = reinterpret_cast<const SlotHeader*>(slot(position));
+        return s->sequence.load(std::memory_order_acquire) == position + 1;
+    });
+}
+
+bool ShmRing::tryPush(const void* data, size_t length) {
+    WriteTicket ticket;
+    if (length > slotSize() || !beginWrite(ticket)) {
+        return false;
+    }
+    std::memcpy(ticket.data, data, length);
+    commitWrite(ticket, length);
+    return true;
+}
+
+size_t ShmRing::slotSize() const {
+    return slotSize_;
+}
+
+size_t ShmRing::slotCount() const {
+    return static_cast<size_t>(slotCount_);
+}
+
+// MARK: - ShmSessionChannel
+
+ShmSessionChannel::ShmSessionChannel(ShmRing sessions, ShmRing results)
+    : sessions_(std::move(sessions)), results_(std::move(results)) {}
+
+ShmSessionChannel ShmSessionChannel::create(const std::string& name, size_t slotCount, size_t maxSetsPerSession) {
+    // One ingest process per channel (see the class comment), so both rings
+    // are single-producer
+    if (maxSetsPerSession > (SIZE_MAX / 2) / (sizeof(double) + sizeof(uint8_t))) {
+        throw std::runtime_error("Sessions of " + std::to_string(maxSetsPerSession) + " sets do not fit a ring slot");
+    }
+    const size_t sessionBytes = sizeof(ShmSessionRecord) + maxSetsPerSession * (sizeof(double) + sizeof(uint8_t));
+    return ShmSessionChannel(
+        ShmRing::create(name + "-sessions", slotCount, sessionBytes, ShmRing::Mode::SingleProducer),
+        ShmRing::create(name + "-results", slotCount, sizeof(ShmResultRecord), ShmRing::Mode::SingleProducer)
+    );
+}
+
+ShmSessionChannel ShmSessionChannel::open(const std::string& name) {
+    ShmRing sessions = ShmRing::open(name + "-sessions");
+    ShmRing results = ShmRing::open(name + "-results");
+    if (sessions.slotSize() < sizeof(ShmSessionRecord) || results.slotSize() < sizeof(ShmResultRecord)) {
+        throw std::runtime_error("Shared memory channel " + name + " has slots too small for its records");
+    }
+    return ShmSessionChannel(std::move(sessions), std::move(results));
+}
+
+size_t ShmSessionChannel::maxSetsPerSession() const {
+    return (sessions_.slotSize() - sizeof(ShmSessionRecord)) / (sizeof(double) + sizeof(uint8_t));
+}
+
+bool ShmSessionChannel::sendSession(
+    uint64_t sessionId,
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    std::chrono::nanoseconds timeout
+) {
+    if (count > maxSetsPerSession()) {
+        return false;
+    }
+
+    ShmRing::WriteTicket ticket;
+    while (!sessions_.beginWrite(ticket)) {
+        if (!sessions_.waitWritable(timeout)) {
+            return false;
+        }
+    }
+
+    // Columnar layout: header, all durations, then all intensities
+    unsigned char* out = static_cast<unsigned char*>(ticket.data);
+    ShmSessionRecord record{sessionId, static_cast<uint32_t>(count), 0};
+    std::memcpy(out, &record, sizeof(record));
+    std::memcpy(out + sizeof(record), durations, count * sizeof(double));
+    std::memcpy(out + sizeof(record) + count * sizeof(double), intensities, count);
+    sessions_.commitWrite(ticket, sizeof(record) + count * (sizeof(double) + sizeof(uint8_t)));
+    return true;
+}
+
+bool ShmSessionChannel::analyzeNext(TennisAnalyzer& analyzer, std::chrono::nanoseconds timeout) {
+    ShmRing::ReadTicket ticket;
+    if (!sessions_.beginRead(ticket)) {
+        TENNIS_TRACE_SCOPE("shm_wait");
+        if (!sessions_.waitReadable(timeout) || !sessions_.beginRead(ticket)) {
+            return false;
+        }
+    }
+
+    // The record comes from another process: only trust a set count that
+    // fits in what was committed, and a length that fits in the slot
+    const unsigned char* in = static_cast<const unsigned char*>(ticket.data);
+    ShmSessionRecord record{};
+    const bool hasHeader = ticket.length >= sizeof(record) && ticket.length <= sessions_.slotSize();
+    if (hasHeader) {
+        std::memcpy(&record, in, sizeof(record));
+    }
+    const bool wellFormed = hasHeader && static_cast<uint64_t>(record.setCount) * (sizeof(double) + sizeof(uint8_t)) <=
+                                             ticket.length - sizeof(record);
+    const double* durations = reinterpret_cast<const double*>(in + sizeof(record));
+    const uint8_t* intensities = in + sizeof(record) + static_cast<size_t>(record.setCount) * sizeof(double);
+
+    // Analyze straight out of the slot; it is released once the result is known
+    ShmResultRecord result{record.sessionId, 0, 0, AnalysisResult{}};
+    if (!wellFormed) {
+        result.status = 2;
+    } else {
+        TENNIS_LATENCY_SCOPE(ShmAnalyze);
+        TENNIS_ALLOCATION_SCOPE(ShmAnalyze);
+        TENNIS_TRACE_SCOPE("shm_analyze", record.sessionId, record.setCount);
+        if (!analyzer.tryAnalyze(durations, intensities, record.setCount, result.result).ok()) {
+            result.status = 1;
+        }
+    }
+    sessions_.commitRead(ticket);
+
+    ShmRing::WriteTicket out;
+    while (!results_.beginWrite(out)) {
+        if (!results_.waitWritable(timeout)) {
+            return false; // The ingest side stopped draining results; drop this one
+        }
+    }
+    std::memcpy(out.data, &result, sizeof(result));
+    results_.commitWrite(out, sizeof(result));
+    return true;
+}
+
+bool ShmSessionChannel::receiveResult(ShmResultRecord& record, std::chrono::nanoseconds timeout) {
+    ShmRing::ReadTicket ticket;
+    if (!results_.beginRead(ticket)) {
+        if (!results_.waitReadable(timeout) || !results_.beginRead(ticket)) {
+            return false;
+        }
+    }
+    std::memcpy(&record, ticket.data, sizeof(record));
+    results_.commitRead(ticket);
+    return true;
+}
+
+} // namespace tennis
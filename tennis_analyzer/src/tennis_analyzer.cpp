@@ -6,242 +6,240 @@
 //
 
 #include "tennis_analyzer.hpp"
+#include "allocation_tracker.hpp"
+#include "analysis_kernels.hpp"
+#include "latency_histogram.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
 #include <stdexcept>
-#include <algorithm>
-#include <numeric>
-#include <cmath>
-#include <limits>
 #include <string>
 
 namespace tennis {
 
-// Constants
-constexpr double MIN_DURATION = 0.0;
-constexpr double MAX_DURATION = 86400.0; // 24 hours
-constexpr uint8_t MIN_INTENSITY = 1;
-constexpr uint8_t MAX_INTENSITY = 5;
-constexpr double EPSILON = 1e-9;
+static void countValidationFailure(ValidationStatus status) {
+    switch (status) {
+        case ValidationStatus::Ok:
+            break;
+        case ValidationStatus::SizeMismatch:
+            incrementMetric(MetricCounter::ValidationSizeMismatch);
+            break;
+        case ValidationStatus::DurationOutOfRange:
+            incrementMetric(MetricCounter::ValidationDurationOutOfRange);
+            break;
+        case ValidationStatus::IntensityOutOfRange:
+            incrementMetric(MetricCounter::ValidationIntensityOutOfRange);
+            break;
+    }
+}
 
 AnalysisResult TennisAnalyzer::analyze(
     const std::vector<double>& durations,
     const std::vector<uint8_t>& intensities
 ) {
-    // Validate inputs
-    validateInputs(durations, intensities);
-    
     AnalysisResult result;
+    ValidationResult validation = tryAnalyze(durations, intensities, result);
+    if (!validation.ok()) {
+        throw std::invalid_argument(validationMessage(validation));
+    }
+    return result;
+}
+
+ValidationResult TennisAnalyzer::tryAnalyze(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities,
+    AnalysisResult& result
+) {
+    return tryAnalyze(durations.data(), durations.size(), intensities.data(), intensities.size(), result);
+}
+
+ValidationResult TennisAnalyzer::tryAnalyze(
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    AnalysisResult& result
+) {
+    return tryAnalyze(durations, count, intensities, count, result);
+}
+
+ValidationResult TennisAnalyzer::tryAnalyze(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount,
+    AnalysisResult& result
+) {
+    TENNIS_LATENCY_SCOPE(Analyze);
+    TENNIS_ALLOCATION_SCOPE(Analyze);
+    TENNIS_TRACE_SCOPE("analyze", TRACE_NO_SESSION, static_cast<uint32_t>(durationCount));
     
-    // Calculate basic metrics
-    result.totalActiveTime = calculateTotalActiveTime(durations);
-    result.workRestRatio = calculateWorkRestRatio(durations);
-    result.consistencyScore = calculateConsistencyScore(durations, intensities);
-    result.trainingDensityScore = calculateTrainingDensityScore(durations, intensities);
-    
-    // Calculate additional metrics
-    result.totalSets = durations.size();
-    
-    // Calculate average intensity
-    double intensitySum = std::accumulate(intensities.begin(), intensities.end(), 0.0);
-    result.averageIntensity = intensitySum / static_cast<double>(intensities.size());
-    
-    // Calculate total work volume (intensity-weighted time)
-    result.totalWorkVolume = 0.0;
-    for (size_t i = 0; i < durations.size(); ++i) {
-        result.totalWorkVolume += durations[i] * static_cast<double>(intensities[i]);
+    // Validate inputs
+    ValidationResult validation = checkInputs(durations, durationCount, intensities, intensityCount);
+    if (!validation.ok()) {
+        countValidationFailure(validation.status);
+        return validation;
+    }
+    const size_t count = durationCount;
+    
+    // Pin one configuration version for the whole analysis
+    ScoringConfigHolder::Snapshot config = (config_ ? *config_ : globalScoringConfig()).snapshot();
+    
+    if (LATENCY_HISTOGRAMS_ENABLED) {
+        // Stage by stage, so each metric gets its own latency sample
+        result.totalActiveTime = calculateTotalActiveTime(durations, count);
+        result.workRestRatio = calculateWorkRestRatio(durations, nullptr, count);
+        result.consistencyScore = calculateConsistencyScore(durations, intensities, count, *config);
+        result.trainingDensityScore = calculateTrainingDensityScore(durations, intensities, count, *config);
+        result.totalSets = count;
+        analysis::intensityMetrics(durations, intensities, count, result);
+    } else {
+        // Same results in two passes over the sets
+        analysis::computeMetrics(durations, intensities, count, *config, result);
     }
     
-    return result;
+    incrementMetric(MetricCounter::SessionsAnalyzed);
+    incrementMetric(MetricCounter::SetsAnalyzed, count);
+    return validation;
 }
 
 double TennisAnalyzer::calculateTotalActiveTime(const std::vector<double>& durations) {
-    if (durations.empty()) {
-        return 0.0;
-    }
+    return calculateTotalActiveTime(durations.data(), durations.size());
+}
+
+double TennisAnalyzer::calculateTotalActiveTime(const double* durations, size_t count) {
+    TENNIS_LATENCY_SCOPE(TotalActiveTime);
+    TENNIS_ALLOCATION_SCOPE(TotalActiveTime);
     
-    return std::accumulate(durations.begin(), durations.end(), 0.0);
+    return analysis::totalActiveTime(durations, count);
 }
 
 double TennisAnalyzer::calculateWorkRestRatio(
     const std::vector<double>& durations,
     const std::vector<double>& restDurations
 ) {
-    if (durations.empty()) {
-        return 0.0;
-    }
-    
-    double totalWork = calculateTotalActiveTime(durations);
-    double totalRest = 0.0;
-    
-    if (restDurations.empty()) {
-        // Default: assume rest equals work (1:1 ratio)
-        totalRest = totalWork;
-    } else {
-        // Use provided rest durations
-        if (restDurations.size() != durations.size()) {
-            throw std::invalid_argument(
-                "Rest durations vector size must match durations vector size"
-            );
-        }
-        totalRest = std::accumulate(restDurations.begin(), restDurations.end(), 0.0);
-    }
-    
-    if (totalRest < EPSILON) {
-        return std::numeric_limits<double>::infinity();
+    if (!durations.empty() && !restDurations.empty() && restDurations.size() != durations.size()) {
+        throw std::invalid_argument(
+            "Rest durations vector size must match durations vector size"
+        );
     }
+    return calculateWorkRestRatio(
+        durations.data(),
+        restDurations.empty() ? nullptr : restDurations.data(),
+        durations.size()
+    );
+}
+
+double TennisAnalyzer::calculateWorkRestRatio(
+    const double* durations,
+    const double* restDurations,
+    size_t count
+) {
+    TENNIS_LATENCY_SCOPE(WorkRestRatio);
+    TENNIS_ALLOCATION_SCOPE(WorkRestRatio);
     
-    return totalWork / totalRest;
+    // Without rest durations, assume rest equals work (1:1 ratio)
+    return analysis::workRestRatio(durations, restDurations, count);
 }
 
 double TennisAnalyzer::calculateConsistencyScore(
     const std::vector<double>& durations,
-    const std::vector<uint8_t>& intensities
+    const std::vector<uint8_t>& intensities,
+    const ScoringConfig& config
 ) {
-    if (durations.size() < 2) {
-        // Single set is considered perfectly consistent
-        return 1.0;
-    }
-    
-    // Calculate duration consistency (coefficient of variation)
-    double durationCV = coefficientOfVariation(durations);
-    double durationConsistency = 1.0 / (1.0 + durationCV);
-    
-    // Calculate intensity consistency
-    std::vector<double> intensityDoubles(intensities.begin(), intensities.end());
-    double intensityCV = coefficientOfVariation(intensityDoubles);
-    double intensityConsistency = 1.0 / (1.0 + intensityCV);
-    
-    // Combined consistency score (weighted average)
-    // Duration consistency: 60%, Intensity consistency: 40%
-    double consistency = 0.6 * durationConsistency + 0.4 * intensityConsistency;
+    return consistencyScore(durations.data(), durations.size(), intensities.data(), intensities.size(), config);
+}
+
+double TennisAnalyzer::calculateConsistencyScore(
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    const ScoringConfig& config
+) {
+    return consistencyScore(durations, count, intensities, count, config);
+}
+
+double TennisAnalyzer::consistencyScore(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount,
+    const ScoringConfig& config
+) {
+    TENNIS_LATENCY_SCOPE(ConsistencyScore);
+    TENNIS_ALLOCATION_SCOPE(ConsistencyScore);
     
-    // Clamp to [0.0, 1.0]
-    return std::max(0.0, std::min(1.0, consistency));
+    return analysis::consistencyScore(durations, durationCount, intensities, intensityCount, config);
 }
 
 double TennisAnalyzer::calculateTrainingDensityScore(
     const std::vector<double>& durations,
-    const std::vector<uint8_t>& intensities
+    const std::vector<uint8_t>& intensities,
+    const ScoringConfig& config
 ) {
-    if (durations.empty()) {
-        return 0.0;
-    }
-    
-    // Calculate average intensity (normalized to 0.0-1.0)
-    double avgIntensity = 0.0;
-    for (uint8_t intensity : intensities) {
-        avgIntensity += normalizeIntensity(intensity);
-    }
-    avgIntensity /= static_cast<double>(intensities.size());
-    
-    // Calculate total work volume (intensity-weighted time)
-    double totalWorkVolume = 0.0;
-    for (size_t i = 0; i < durations.size(); ++i) {
-        totalWorkVolume += durations[i] * normalizeIntensity(intensities[i]);
-    }
-    
-    // Calculate average duration
-    double avgDuration = mean(durations);
-    
-    // Normalize metrics
-    // Intensity component: 0.0-1.0 (already normalized)
-    // Volume component: normalize by max possible (assuming max intensity and reasonable duration)
-    const double maxDuration = 3600.0; // 1 hour per set (reasonable max)
-    double volumeComponent = std::min(1.0, totalWorkVolume / (maxDuration * durations.size()));
-    
-    // Duration distribution component (penalize very short or very long sets)
-    double durationComponent = 1.0;
-    if (avgDuration < 30.0) {
-        // Very short sets reduce density
-        durationComponent = avgDuration / 30.0;
-    } else if (avgDuration > 1800.0) {
-        // Very long sets also reduce density (fatigue factor)
-        durationComponent = 1800.0 / avgDuration;
-    }
-    
-    // Combined density score
-    // Intensity: 40%, Volume: 40%, Duration: 20%
-    double density = 0.4 * avgIntensity + 0.4 * volumeComponent + 0.2 * durationComponent;
+    return trainingDensityScore(durations.data(), durations.size(), intensities.data(), intensities.size(), config);
+}
+
+double TennisAnalyzer::calculateTrainingDensityScore(
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    const ScoringConfig& config
+) {
+    return trainingDensityScore(durations, count, intensities, count, config);
+}
+
+double TennisAnalyzer::trainingDensityScore(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount,
+    const ScoringConfig& config
+) {
+    TENNIS_LATENCY_SCOPE(TrainingDensityScore);
+    TENNIS_ALLOCATION_SCOPE(TrainingDensityScore);
     
-    // Clamp to [0.0, 1.0]
-    return std::max(0.0, std::min(1.0, density));
+    return analysis::trainingDensityScore(durations, durationCount, intensities, intensityCount, config);
 }
 
 void TennisAnalyzer::validateInputs(
     const std::vector<double>& durations,
     const std::vector<uint8_t>& intensities
 ) {
-    // Check vector sizes match
-    if (durations.size() != intensities.size()) {
-        throw std::invalid_argument(
-            "Durations and intensities vectors must have the same size"
-        );
-    }
-    
-    // Check durations are valid
-    for (size_t i = 0; i < durations.size(); ++i) {
-        if (durations[i] < MIN_DURATION || durations[i] > MAX_DURATION) {
-            throw std::invalid_argument(
-                "Duration at index " + std::to_string(i) + 
-                " is out of valid range [0, 86400] seconds"
-            );
-        }
-    }
-    
-    // Check intensities are valid
-    for (size_t i = 0; i < intensities.size(); ++i) {
-        if (intensities[i] < MIN_INTENSITY || intensities[i] > MAX_INTENSITY) {
-            throw std::invalid_argument(
-                "Intensity at index " + std::to_string(i) + 
-                " is out of valid range [1, 5]"
-            );
-        }
+    ValidationResult validation = checkInputs(durations, intensities);
+    if (!validation.ok()) {
+        countValidationFailure(validation.status);
+        throw std::invalid_argument(validationMessage(validation));
     }
 }
 
-double TennisAnalyzer::mean(const std::vector<double>& values) {
-    if (values.empty()) {
-        return 0.0;
-    }
-    
-    double sum = std::accumulate(values.begin(), values.end(), 0.0);
-    return sum / static_cast<double>(values.size());
+ValidationResult TennisAnalyzer::checkInputs(
+    const std::vector<double>& durations,
+    const std::vector<uint8_t>& intensities
+) noexcept {
+    return checkInputs(durations.data(), durations.size(), intensities.data(), intensities.size());
 }
 
-double TennisAnalyzer::standardDeviation(const std::vector<double>& values) {
-    if (values.size() < 2) {
-        return 0.0;
-    }
-    
-    double meanValue = mean(values);
-    double sumSquaredDiff = 0.0;
-    
-    for (double value : values) {
-        double diff = value - meanValue;
-        sumSquaredDiff += diff * diff;
-    }
-    
-    double variance = sumSquaredDiff / static_cast<double>(values.size() - 1);
-    return std::sqrt(variance);
+ValidationResult TennisAnalyzer::checkInputs(
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count
+) noexcept {
+    return checkInputs(durations, count, intensities, count);
 }
 
-double TennisAnalyzer::coefficientOfVariation(const std::vector<double>& values) {
-    if (values.empty()) {
-        return 0.0;
-    }
-    
-    double meanValue = mean(values);
-    if (std::abs(meanValue) < EPSILON) {
-        return 0.0;
-    }
-    
-    double stdDev = standardDeviation(values);
-    return stdDev / meanValue;
+ValidationResult TennisAnalyzer::checkInputs(
+    const double* durations,
+    size_t durationCount,
+    const uint8_t* intensities,
+    size_t intensityCount
+) noexcept {
+    TENNIS_LATENCY_SCOPE(Validate);
+    TENNIS_ALLOCATION_SCOPE(Validate);
+    
+    return analysis::checkInputs(durations, durationCount, intensities, intensityCount);
 }
 
-double TennisAnalyzer::normalizeIntensity(uint8_t intensity) {
-    // Normalize from [1, 5] to [0.0, 1.0]
-    return static_cast<double>(intensity - MIN_INTENSITY) / 
-           static_cast<double>(MAX_INTENSITY - MIN_INTENSITY);
+std::string TennisAnalyzer::validationMessage(const ValidationResult& validation) {
+    return analysis::validationMessage(validation);
 }
 
 } // namespace tennis
@@ -0,0 +1,292 @@
+//
+//  tennis_analyzer_c.cpp
+//  Tennis Training Session Analyzer
+//
+//  C interface over TennisAnalyzer's pointer-based entry points
+//
+
+#include "tennis_analyzer_c.h"
+#include "allocation_tracker.hpp"
+#include "latency_histogram.hpp"
+#include "metrics.hpp"
+#include "tennis_analyzer.hpp"
+#include "trace.hpp"
+#include <cmath>
+#include <limits>
+#include <new>
+
+struct tennis_analyzer {
+    tennis::TennisAnalyzer analyzer;
+};
+
+namespace {
+
+using tennis::AnalysisResult;
+using tennis::ValidationResult;
+using tennis::ValidationStatus;
+
+/**
+ * @brief Run fn, mapping any exception to a status so none crosses into C
+ */
+template <typename Fn>
+tennis_status guarded(Fn&& fn) noexcept {
+    try {
+        return fn();
+    } catch (const std::bad_alloc&) {
+        return TENNIS_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return TENNIS_ERROR_INTERNAL;
+    }
+}
+
+template <typename Fn>
+double guardedValue(Fn&& fn) noexcept {
+    try {
+        return fn();
+    } catch (...) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+tennis_status toStatus(const ValidationResult& validation) {
+    switch (validation.status) {
+        case ValidationStatus::Ok:
+            return TENNIS_OK;
+        case ValidationStatus::DurationOutOfRange:
+            return TENNIS_ERROR_DURATION_OUT_OF_RANGE;
+        case ValidationStatus::IntensityOutOfRange:
+            return TENNIS_ERROR_INTENSITY_OUT_OF_RANGE;
+        case ValidationStatus::SizeMismatch:
+            break; // One count covers both arrays
+    }
+    return TENNIS_ERROR_INTERNAL;
+}
+
+void toCResult(const AnalysisResult& in, tennis_analysis_result& out) {
+    out.total_active_time = in.totalActiveTime;
+    out.work_rest_ratio = in.workRestRatio;
+    out.consistency_score = in.consistencyScore;
+    out.training_density_score = in.trainingDensityScore;
+    out.average_intensity = in.averageIntensity;
+    out.total_work_volume = in.totalWorkVolume;
+    out.total_sets = in.totalSets;
+}
+
+/**
+ * @brief Write one entry of an optional output column
+ */
+template <typename T>
+void store(T* column, size_t index, T value) {
+    if (column) {
+        column[index] = value;
+    }
+}
+
+bool validArrays(const void* durations, const void* intensities, size_t count) {
+    return count == 0 || (durations && intensities);
+}
+
+/**
+ * @brief Shared body of the batch entry points
+ *
+ * Checks every argument before analyzing anything, then hands each
+ * session's status and result to write(session, status, result, errorIndex).
+ */
+template <typename Write>
+tennis_status analyzeBatch(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    const size_t* offsets,
+    size_t sessionCount,
+    size_t* failedSessions,
+    Write&& write
+) {
+    if (!analyzer || (sessionCount > 0 && !offsets)) {
+        return TENNIS_ERROR_INVALID_ARGUMENT;
+    }
+    for (size_t s = 0; s < sessionCount; ++s) {
+        if (offsets[s] > offsets[s + 1]) {
+            return TENNIS_ERROR_INVALID_ARGUMENT;
+        }
+    }
+    if (sessionCount > 0 && !validArrays(durations, intensities, offsets[sessionCount] - offsets[0])) {
+        return TENNIS_ERROR_INVALID_ARGUMENT;
+    }
+
+    TENNIS_LATENCY_SCOPE(AnalyzeBatch);
+    TENNIS_ALLOCATION_SCOPE(AnalyzeBatch);
+    TENNIS_TRACE_SCOPE("analyze_batch", tennis::TRACE_NO_SESSION,
+                       static_cast<uint32_t>(sessionCount > 0 ? offsets[sessionCount] - offsets[0] : 0));
+    tennis::incrementMetric(tennis::MetricCounter::BatchesAnalyzed);
+
+    size_t failed = 0;
+    for (size_t s = 0; s < sessionCount; ++s) {
+        const size_t first = offsets[s];
+        const size_t count = offsets[s + 1] - first;
+        AnalysisResult result{};
+        ValidationResult validation = analyzer->analyzer.tryAnalyze(
+            count > 0 ? durations + first : nullptr,
+            count > 0 ? intensities + first : nullptr,
+            count,
+            result
+        );
+        if (!validation.ok()) {
+            result = AnalysisResult{};
+            ++failed;
+        }
+        write(s, toStatus(validation), result, validation.index);
+    }
+    if (failedSessions) {
+        *failedSessions = failed;
+    }
+    return TENNIS_OK;
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t tennis_abi_version(void) {
+    return TENNIS_C_ABI_VERSION;
+}
+
+const char* tennis_status_message(tennis_status status) {
+    switch (status) {
+        case TENNIS_OK:
+            return "ok";
+        case TENNIS_ERROR_DURATION_OUT_OF_RANGE:
+            return "duration out of valid range [0, 86400] seconds";
+        case TENNIS_ERROR_INTENSITY_OUT_OF_RANGE:
+            return "intensity out of valid range [1, 5]";
+        case TENNIS_ERROR_INVALID_ARGUMENT:
+            return "invalid argument";
+        case TENNIS_ERROR_OUT_OF_MEMORY:
+            return "out of memory";
+        case TENNIS_ERROR_INTERNAL:
+            return "internal error";
+    }
+    return "unknown status";
+}
+
+tennis_analyzer* tennis_analyzer_create(void) {
+    return new (std::nothrow) tennis_analyzer();
+}
+
+void tennis_analyzer_destroy(tennis_analyzer* analyzer) {
+    delete analyzer;
+}
+
+tennis_status tennis_analyze(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    size_t count,
+    tennis_analysis_result* result,
+    size_t* error_index
+) {
+    if (!analyzer || !result || !validArrays(durations, intensities, count)) {
+        return TENNIS_ERROR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        AnalysisResult analysis;
+        ValidationResult validation = analyzer->analyzer.tryAnalyze(durations, intensities, count, analysis);
+        if (!validation.ok()) {
+            if (error_index) {
+                *error_index = validation.index;
+            }
+            return toStatus(validation);
+        }
+        toCResult(analysis, *result);
+        return static_cast<tennis_status>(TENNIS_OK);
+    });
+}
+
+tennis_status tennis_analyze_batch(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    const size_t* offsets,
+    size_t session_count,
+    tennis_analysis_result* results,
+    tennis_status* statuses,
+    size_t* failed_sessions
+) {
+    if (session_count > 0 && !results) {
+        return TENNIS_ERROR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        return analyzeBatch(analyzer, durations, intensities, offsets, session_count, failed_sessions,
+                            [&](size_t s, tennis_status status, const AnalysisResult& result, size_t) {
+                                toCResult(result, results[s]);
+                                if (statuses) {
+                                    statuses[s] = status;
+                                }
+                            });
+    });
+}
+
+tennis_status tennis_analyze_batch_columns(
+    tennis_analyzer* analyzer,
+    const double* durations,
+    const uint8_t* intensities,
+    const size_t* offsets,
+    size_t session_count,
+    const tennis_result_columns* columns,
+    size_t* failed_sessions
+) {
+    if (!columns) {
+        return TENNIS_ERROR_INVALID_ARGUMENT;
+    }
+    const tennis_result_columns out = *columns;
+    return guarded([&] {
+        return analyzeBatch(analyzer, durations, intensities, offsets, session_count, failed_sessions,
+                            [&](size_t s, tennis_status status, const AnalysisResult& result, size_t index) {
+                                store(out.total_active_time, s, result.totalActiveTime);
+                                store(out.work_rest_ratio, s, result.workRestRatio);
+                                store(out.consistency_score, s, result.consistencyScore);
+                                store(out.training_density_score, s, result.trainingDensityScore);
+                                store(out.average_intensity, s, result.averageIntensity);
+                                store(out.total_work_volume, s, result.totalWorkVolume);
+                                store(out.total_sets, s, static_cast<uint64_t>(result.totalSets));
+                                store(out.status, s, status);
+                                store(out.error_index, s, static_cast<uint64_t>(status == TENNIS_OK ? 0 : index));
+                            });
+    });
+}
+
+double tennis_total_active_time(const double* durations, size_t count) {
+    if (count > 0 && !durations) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return guardedValue([&] { return tennis::TennisAnalyzer::calculateTotalActiveTime(durations, count); });
+}
+
+double tennis_work_rest_ratio(const double* durations, const double* rest_durations, size_t count) {
+    if (count > 0 && !durations) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return guardedValue([&] {
+        return tennis::TennisAnalyzer::calculateWorkRestRatio(durations, rest_durations, count);
+    });
+}
+
+double tennis_consistency_score(const double* durations, const uint8_t* intensities, size_t count) {
+    if (!validArrays(durations, intensities, count)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return guardedValue([&] {
+        return tennis::TennisAnalyzer::calculateConsistencyScore(durations, intensities, count);
+    });
+}
+
+double tennis_training_density_score(const double* durations, const uint8_t* intensities, size_t count) {
+    if (!validArrays(durations, intensities, count)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return guardedValue([&] {
+        return tennis::TennisAnalyzer::calculateTrainingDensityScore(durations, intensities, count);
+    });
+}
+
+} // extern "C"
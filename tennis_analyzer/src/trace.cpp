@@ -0,0 +1,292 @@
+//
+//  trace.cpp
+//  Tennis Training Session Analyzer
+//
+//  Per-thread trace buffers and Chrome trace JSON output
+//
+
+#include "trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace tennis {
+
+namespace {
+
+struct TraceEventRecord {
+    const char* name;
+    const char* argName;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint64_t sessionId;
+    uint64_t argValue;
+    uint32_t setCount;
+};
+
+/**
+ * @brief One thread's events for the current trace
+ *
+ * Only the owning thread writes events and resets the buffer; it publishes
+ * each event with a release store of `published`, so a writer of the trace
+ * can read every slot below that count without locking.
+ */
+struct ThreadTraceBuffer {
+    uint32_t tid = 0;
+    std::string name;                  // Guarded by the registry mutex
+    std::unique_ptr<TraceEventRecord[]> events;
+    size_t capacity = 0;
+    std::atomic<size_t> published{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> epoch{0};    // Trace this buffer's contents belong to
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    std::atomic<bool> active{false};
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<size_t> capacity{0};
+    uint64_t originNs = 0;
+    uint32_t nextTid = 1;
+};
+
+TraceRegistry& registry() {
+    // Leaked so threads exiting during static destruction can still record
+    static TraceRegistry* instance = new TraceRegistry();
+    return *instance;
+}
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief The calling thread's buffer, registered on first use
+ *
+ * The registry keeps a reference too, so events from threads that have
+ * exited (e.g. joined workers) are still written out.
+ */
+ThreadTraceBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadTraceBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadTraceBuffer>();
+        TraceRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->tid = r.nextTid++;
+        r.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void appendEscaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+}
+
+void appendMicroseconds(std::string& out, uint64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu",
+                  static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+    out += text;
+}
+
+} // namespace
+
+void traceStart(size_t eventsPerThread) {
+    if (!TRACING_ENABLED) {
+        return;
+    }
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Forget buffers of threads that have exited; only the registry holds them
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> live;
+    for (std::shared_ptr<ThreadTraceBuffer>& buffer : r.buffers) {
+        if (buffer.use_count() > 1) {
+            live.push_back(std::move(buffer));
+        }
+    }
+    r.buffers.swap(live);
+
+    r.originNs = steadyNowNs();
+    r.capacity.store(eventsPerThread > 0 ? eventsPerThread : 1, std::memory_order_relaxed);
+    r.epoch.fetch_add(1, std::memory_order_release);
+    r.active.store(true, std::memory_order_release);
+}
+
+void traceStop() {
+    registry().active.store(false, std::memory_order_release);
+}
+
+bool tracingActive() {
+    return TRACING_ENABLED && registry().active.load(std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const std::string& name) {
+    if (!TRACING_ENABLED) {
+        return;
+    }
+    ThreadTraceBuffer& buffer = threadBuffer();
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    buffer.name = name;
+}
+
+#if TENNIS_ANALYZER_ENABLE_TRACING
+
+uint64_t traceNow() {
+    return steadyNowNs();
+}
+
+void recordTraceEvent(const char* name, uint64_t startNs, uint64_t endNs,
+                      uint64_t sessionId, uint32_t setCount,
+                      const char* argName, uint64_t argValue) {
+    TraceRegistry& r = registry();
+    if (!r.active.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    ThreadTraceBuffer& buffer = threadBuffer();
+    const uint64_t epoch = r.epoch.load(std::memory_order_acquire);
+    if (buffer.epoch.load(std::memory_order_relaxed) != epoch) {
+        // First event of a new trace on this thread: start an empty buffer
+        const size_t capacity = r.capacity.load(std::memory_order_relaxed);
+        buffer.published.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        if (buffer.capacity != capacity) {
+            buffer.events.reset(new TraceEventRecord[capacity]);
+            buffer.capacity = capacity;
+        }
+        buffer.epoch.store(epoch, std::memory_order_release);
+    }
+
+    const size_t index = buffer.published.load(std::memory_order_relaxed);
+    if (index == buffer.capacity) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = TraceEventRecord{name, argName, startNs, endNs, sessionId, argValue, setCount};
+    buffer.published.store(index + 1, std::memory_order_release);
+}
+
+#endif // TENNIS_ANALYZER_ENABLE_TRACING
+
+size_t writeChromeTrace(std::ostream& out) {
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const uint64_t epoch = r.epoch.load(std::memory_order_acquire);
+
+    size_t written = 0;
+    uint64_t dropped = 0;
+    bool first = true;
+    std::string json;
+    json.reserve(1 << 16);
+    json += "{\"traceEvents\":[";
+
+    auto separator = [&] {
+        if (!first) {
+            json += ',';
+        }
+        json += '\n';
+        first = false;
+    };
+
+    for (const std::shared_ptr<ThreadTraceBuffer>& buffer : r.buffers) {
+        const std::string tid = std::to_string(buffer->tid);
+        if (!buffer->name.empty()) {
+            separator();
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+            appendEscaped(json, buffer->name);
+            json += "\"}}";
+        }
+        if (buffer->epoch.load(std::memory_order_acquire) != epoch) {
+            continue; // Nothing recorded by this thread in the current trace
+        }
+
+        const size_t count = buffer->published.load(std::memory_order_acquire);
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEventRecord& e = buffer->events[i];
+            const uint64_t start = e.startNs > r.originNs ? e.startNs - r.originNs : 0;
+            const uint64_t duration = e.endNs > e.startNs ? e.endNs - e.startNs : 0;
+
+            separator();
+            json += "{\"name\":\"";
+            json += e.name;
+            json += "\",\"cat\":\"tennis\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds(json, start);
+            json += ",\"dur\":";
+            appendMicroseconds(json, duration);
+            json += ",\"args\":{";
+            bool firstArg = true;
+            if (e.sessionId != TRACE_NO_SESSION) {
+                json += "\"session\":" + std::to_string(e.sessionId);
+                firstArg = false;
+            }
+            if (e.setCount != 0) {
+                json += firstArg ? "" : ",";
+                json += "\"sets\":" + std::to_string(e.setCount);
+                firstArg = false;
+            }
+            if (e.argName) {
+                json += firstArg ? "\"" : ",\"";
+                json += e.argName;
+                json += "\":" + std::to_string(e.argValue);
+            }
+            json += "}}";
+            ++written;
+        }
+
+        if (json.size() > (1 << 20)) {
+            out << json;
+            json.clear();
+        }
+    }
+
+    json += "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":" + std::to_string(dropped) + "}}\n";
+    out << json;
+    return written;
+}
+
+size_t writeChromeTraceFile(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    size_t written = writeChromeTrace(file);
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("Failed to write trace file " + path);
+    }
+    return written;
+}
+
+uint64_t traceDroppedEvents() {
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const uint64_t epoch = r.epoch.load(std::memory_order_acquire);
+
+    uint64_t dropped = 0;
+    for (const std::shared_ptr<ThreadTraceBuffer>& buffer : r.buffers) {
+        if (buffer->epoch.load(std::memory_order_acquire) == epoch) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+} // namespace tennis
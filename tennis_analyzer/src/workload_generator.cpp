@@ -0,0 +1,263 @@
+//
+//  workload_generator.cpp
+//  Tennis Training Session Analyzer
+//
+//  Implementation of the synthetic workload generator
+//
+
+#include "workload_generator.hpp"
+#include "session_batch.hpp"
+#include "session_file.hpp"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace tennis {
+
+/**
+ * @brief SplitMix64 step, used for seeding
+ */
+static uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Inverse CDF of the triangular distribution
+ *
+ * sqrt is correctly rounded under IEEE-754, so results are reproducible.
+ */
+static double triangularQuantile(double u, double low, double mode, double high) {
+    const double width = high - low;
+    if (width <= 0.0) {
+        return low;
+    }
+    if (u < (mode - low) / width) {
+        return low + std::sqrt(u * width * (mode - low));
+    }
+    return high - std::sqrt((1.0 - u) * width * (high - mode));
+}
+
+static uint64_t rotateLeft(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// MARK: - WorkloadRandom
+
+WorkloadRandom::WorkloadRandom(uint64_t seed) {
+    for (uint64_t& word : state_) {
+        word = splitMix64(seed);
+    }
+}
+
+uint64_t WorkloadRandom::next() {
+    const uint64_t result = rotateLeft(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotateLeft(state_[3], 45);
+
+    return result;
+}
+
+double WorkloadRandom::uniform() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+uint64_t WorkloadRandom::uniformInt(uint64_t low, uint64_t high) {
+    const uint64_t range = high - low + 1;
+    if (range == 0) {
+        return next(); // Full 64-bit range
+    }
+
+    // Reject the top partial bucket so every value is equally likely
+    const uint64_t threshold = (0 - range) % range;
+    while (true) {
+        const uint64_t value = next();
+        if (value >= threshold) {
+            return low + value % range;
+        }
+    }
+}
+
+double WorkloadRandom::triangular(double low, double mode, double high) {
+    return triangularQuantile(uniform(), low, mode, high);
+}
+
+// MARK: - WorkloadGenerator
+
+/**
+ * @brief Pick an index with probability proportional to its weight
+ */
+static size_t pickWeighted(double roll, const double* weights, size_t count) {
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        total += weights[i];
+    }
+
+    double cumulative = 0.0;
+    const double target = roll * total;
+    for (size_t i = 0; i < count; ++i) {
+        cumulative += weights[i];
+        if (target < cumulative) {
+            return i;
+        }
+    }
+    return count - 1;
+}
+
+static void checkWeights(const double* weights, size_t count, const char* what) {
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!(weights[i] >= 0.0)) {
+            throw std::invalid_argument(std::string(what) + " weights must be non-negative");
+        }
+        total += weights[i];
+    }
+    if (!(total > 0.0)) {
+        throw std::invalid_argument(std::string(what) + " weights must not all be zero");
+    }
+}
+
+static void checkRange(double low, double mode, double high, const char* what) {
+    if (!(low >= 0.0 && low <= mode && mode <= high)) {
+        throw std::invalid_argument(std::string(what) + " must satisfy 0 <= min <= typical <= max");
+    }
+}
+
+WorkloadGenerator::WorkloadGenerator(WorkloadConfig config) : config_(config) {
+    if (config_.minSets == 0 || config_.minSets > config_.maxSets) {
+        throw std::invalid_argument("Set count range must satisfy 1 <= minSets <= maxSets");
+    }
+    if (config_.maxSets > UINT32_MAX) {
+        throw std::invalid_argument("maxSets exceeds the session file limit");
+    }
+    checkWeights(config_.typeMix, SET_TYPE_COUNT, "Set type mix");
+    for (const SetTypeProfile& profile : config_.profiles) {
+        checkRange(profile.minDuration, profile.typicalDuration, profile.maxDuration, "Set durations");
+        checkWeights(profile.intensityWeights, 5, "Intensity");
+    }
+    checkRange(config_.minRest, config_.typicalRest, config_.maxRest, "Rest gaps");
+    if (!(config_.overlapRate >= 0.0 && config_.overlapRate <= 1.0) ||
+        !(config_.invalidRate >= 0.0 && config_.invalidRate <= 1.0)) {
+        throw std::invalid_argument("Overlap and invalid rates must be in [0, 1]");
+    }
+}
+
+void WorkloadGenerator::generate(uint64_t index, GeneratedSession& out) const {
+    // Derive an independent stream per session from (seed, index)
+    uint64_t mix = index;
+    uint64_t sessionSeed = config_.seed ^ splitMix64(mix);
+    WorkloadRandom random(splitMix64(sessionSeed));
+
+    const size_t sets = static_cast<size_t>(random.uniformInt(config_.minSets, config_.maxSets));
+
+    out.sessionId = index;
+    out.types.resize(sets);
+    out.durations.resize(sets);
+    out.intensities.resize(sets);
+    out.startTimes.resize(sets);
+    out.restDurations.resize(sets - 1);
+    out.invalidRecords = 0;
+    out.overlaps = 0;
+
+    double clock = 0.0;
+    for (size_t i = 0; i < sets; ++i) {
+        // Every draw happens unconditionally, in a fixed order, so changing
+        // a rate only changes the records it affects
+        const double typeRoll = random.uniform();
+        const double durationDraw = random.uniform();
+        const double intensityRoll = random.uniform();
+        const double invalidRoll = random.uniform();
+        const uint64_t invalidKind = random.next();
+        const double invalidAmount = random.uniform();
+
+        const size_t type = pickWeighted(typeRoll, config_.typeMix, SET_TYPE_COUNT);
+        const SetTypeProfile& profile = config_.profiles[type];
+
+        double duration = triangularQuantile(durationDraw, profile.minDuration,
+                                             profile.typicalDuration, profile.maxDuration);
+        uint8_t intensity = static_cast<uint8_t>(1 + pickWeighted(intensityRoll, profile.intensityWeights, 5));
+
+        if (invalidRoll < config_.invalidRate) {
+            switch (invalidKind % 4) {
+                case 0: duration = -(1.0 + invalidAmount * 60.0); break;          // Negative duration
+                case 1: duration = 86401.0 + invalidAmount * 86400.0; break;      // Longer than a day
+                case 2: intensity = 0; break;                                     // Below the scale
+                default: intensity = static_cast<uint8_t>(6 + invalidKind % 5); break; // Above the scale
+            }
+            ++out.invalidRecords;
+        }
+
+        out.types[i] = static_cast<SetType>(type);
+        out.durations[i] = duration;
+        out.intensities[i] = intensity;
+        out.startTimes[i] = clock;
+
+        const double restDraw = random.triangular(config_.minRest, config_.typicalRest, config_.maxRest);
+        const double overlapRoll = random.uniform();
+        const double overlapAmount = random.uniform();
+        if (i + 1 < sets) {
+            double rest = restDraw;
+            if (overlapRoll < config_.overlapRate && duration > 0.0) {
+                // Next set starts up to halfway back into this one
+                rest = -(overlapAmount * 0.5 * duration);
+                ++out.overlaps;
+            }
+            out.restDurations[i] = rest;
+            clock += duration + rest;
+        }
+    }
+}
+
+GeneratedSession WorkloadGenerator::next() {
+    GeneratedSession session;
+    generate(nextIndex_++, session);
+    return session;
+}
+
+size_t WorkloadGenerator::fillBatch(SessionBatch& batch, size_t count, uint64_t first) const {
+    GeneratedSession session;
+    size_t invalidSessions = 0;
+
+    const size_t averageSets = (config_.minSets + config_.maxSets) / 2;
+    batch.reserve(batch.sessionCount() + count, batch.totalSetCount() + count * averageSets);
+
+    for (size_t k = 0; k < count; ++k) {
+        generate(first + k, session);
+        batch.addSession(session.durations, session.intensities);
+        if (!session.valid()) {
+            ++invalidSessions;
+        }
+    }
+    return invalidSessions;
+}
+
+std::vector<std::string> WorkloadGenerator::writeFiles(
+    const std::string& directory,
+    size_t count,
+    uint64_t first
+) const {
+    GeneratedSession session;
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    for (size_t k = 0; k < count; ++k) {
+        generate(first + k, session);
+
+        char name[48];
+        std::snprintf(name, sizeof(name), "/session_%08llu.tpsf",
+                      static_cast<unsigned long long>(first + k));
+        paths.push_back(directory + name);
+        writeSessionFile(paths.back(), session.sessionId, session.durations, session.intensities);
+    }
+    return paths;
+}
+
+} // namespace tennis
@@ -0,0 +1,102 @@
+//
+//  admission_decay_test.cpp
+//  Tennis Training Session Analyzer
+//
+//  The interactive load signal behind batch deferral must decay with
+//  elapsed time, not with how often workers wake up to look at it
+//
+
+#include "decaying_estimate.hpp"
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+
+namespace {
+
+using tennis::DecayingEstimate;
+using Clock = DecayingEstimate::Clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// AnalysisService defaults: 20 ms latency target, time constant of 20 targets
+constexpr double ALPHA = 0.05;
+constexpr double TARGET_NS = 20e6;
+const Clock::duration TIME_CONSTANT = milliseconds(400);
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// Batch work is deferred while the smoothed interactive delay exceeds the target
+bool defersBatch(const DecayingEstimate& delay) {
+    return delay.value() > TARGET_NS;
+}
+
+// Interactive requests that each waited three latency targets
+DecayingEstimate loaded(Clock::time_point start) {
+    DecayingEstimate delay(ALPHA, TIME_CONSTANT);
+    for (int i = 0; i < 200; ++i) {
+        delay.addSample(3.0 * TARGET_NS, start);
+    }
+    return delay;
+}
+
+void sameDecisionForAnyWakeupCount() {
+    const Clock::time_point start{};
+    // Quiet periods on both sides of where the signal crosses the target
+    for (int quietMs : {1, 50, 200, 400, 439, 440, 441, 600, 2000}) {
+        const Clock::time_point end = start + milliseconds(quietMs);
+        for (int wakeups : {1, 2, 10, 1000, 100000}) {
+            DecayingEstimate once = loaded(start);
+            once.decay(end);
+
+            DecayingEstimate often = loaded(start);
+            for (int k = 1; k <= wakeups; ++k) {
+                often.decay(start + (end - start) * k / wakeups);
+            }
+            check(std::abs(often.value() - once.value()) <= 1e-9 * once.value(),
+                  "the decayed delay depends only on elapsed time");
+            check(defersBatch(often) == defersBatch(once), "the deferral decision ignores the wakeup count");
+        }
+    }
+}
+
+void burstOfWakeupsKeepsTheSignal() {
+    // One notify per batch submit: 10000 wakeups within a millisecond
+    const Clock::time_point start{};
+    DecayingEstimate delay = loaded(start);
+    for (int k = 1; k <= 10000; ++k) {
+        delay.decay(start + microseconds(1000) * k / 10000);
+    }
+    check(defersBatch(delay), "a burst of wakeups does not end the deferral");
+}
+
+void quietPeriodEndsTheDeferral() {
+    const Clock::time_point start{};
+    DecayingEstimate delay = loaded(start);
+    delay.decay(start + milliseconds(100));
+    check(defersBatch(delay), "deferral holds shortly after interactive load");
+    delay.decay(start + milliseconds(1000));
+    check(!defersBatch(delay), "deferral ends after a quiet second");
+    delay.decay(start + milliseconds(500));
+    check(!defersBatch(delay), "a timestamp from the past does not restore the signal");
+}
+
+} // namespace
+
+int main() {
+    sameDecisionForAnyWakeupCount();
+    burstOfWakeupsKeepsTheSignal();
+    quietPeriodEndsTheDeferral();
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("admission decay: all checks passed\n");
+    return 0;
+}